@@ -0,0 +1,133 @@
+///////////////////////////////////////////////////////////////////////////////
+// DuckSystemBench.cpp
+// ===================
+// Compares DuckSystem::animate (SoA, one loop) with calling DuckTarget::animate
+// on every duck object at the same duck count, checks both paths agree on the
+// duck positions, and reports the best step against the 2 ms per 1M ducks target.
+//
+// usage: DuckSystemBench [ducks] [steps]
+///////////////////////////////////////////////////////////////////////////////
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+
+#include "Vectors.h"
+#include "Matrices.h"
+#include "DuckSystem.h"
+#include "DuckTarget.h"
+
+typedef std::chrono::steady_clock Clock;
+
+// one animate step of a million ducks
+static const double TARGET_MS_PER_MILLION = 2.0;
+
+// same layout as the gallery: six ducks per lane, three on top and three flipped underneath
+static void fillSystem(DuckSystem& system, int count)
+{
+	static const float xs[6] = { -8.0f, 0.0f, 8.0f, 8.0f, 0.0f, -8.0f };
+	system.reserve(count);
+	for (int i = 0; i < count; i++)
+		system.addDuck(xs[i % 6], (i % 6) >= 3, -8.0f - 4.0f * (i / 6));
+}
+
+static void fillObjects(std::vector<DuckTarget>& objects, int count)
+{
+	static const float xs[6] = { -8.0f, 0.0f, 8.0f, 8.0f, 0.0f, -8.0f };
+	objects.reserve(count);
+	for (int i = 0; i < count; i++)
+		objects.push_back(DuckTarget(xs[i % 6], (i % 6) >= 3, -8.0f - 4.0f * (i / 6)));
+}
+
+static void report(const char* name, const std::vector<double>& ms, int ducks)
+{
+	double best = ms[0], total = 0;
+	for (size_t i = 0; i < ms.size(); i++)
+	{
+		best = ms[i] < best ? ms[i] : best;
+		total += ms[i];
+	}
+	double avg = total / ms.size();
+	// ns per duck is the same number as ms per million ducks
+	double perMillion = best * 1.0e6 / ducks;
+	std::cout << std::left << std::setw(14) << name
+		<< std::right << std::setw(9) << ducks << " ducks  "
+		<< "min " << std::setw(8) << best << " ms  "
+		<< "avg " << std::setw(8) << avg << " ms  "
+		<< std::setw(7) << perMillion << " ms/1M  "
+		<< (perMillion <= TARGET_MS_PER_MILLION ? "meets" : "misses")
+		<< " the " << TARGET_MS_PER_MILLION << " ms target" << std::endl;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// run both paths side by side, hitting some ducks on the way, and compare state
+///////////////////////////////////////////////////////////////////////////////
+static bool checkSamePath(int steps)
+{
+	const int count = 60;
+	DuckSystem system;
+	std::vector<DuckTarget> objects;
+	fillSystem(system, count);
+	fillObjects(objects, count);
+
+	float maxError = 0.0f;
+	for (int step = 0; step < steps; step++)
+	{
+		if (step % 97 == 0)
+		{
+			int duck = (step / 97) % count;
+			system.flip(duck);
+			objects[duck].flip();
+		}
+		system.animate(true);
+		for (int i = 0; i < count; i++)
+			objects[i].animate(true);
+
+		for (int i = 0; i < count; i++)
+		{
+			maxError = fmaxf(maxError, fabsf(system.getDuckX()[i] - objects[i].getDuckX()));
+			maxError = fmaxf(maxError, fabsf(system.getDuckY()[i] - objects[i].getDuckY()));
+			maxError = fmaxf(maxError, fabsf(system.getSpin()[i] - objects[i].getSpin()));
+			maxError = fmaxf(maxError, fabsf(system.getFlipAngle()[i] - objects[i].getFlipAngle()));
+		}
+	}
+	std::cout << "max difference after " << steps << " steps: " << maxError << std::endl;
+	// the wave uses a polynomial sin in DuckSystem, allow for that drift
+	return maxError < 1.0e-3f;
+}
+
+int main(int argc, char** argv)
+{
+	int ducks = argc > 1 ? atoi(argv[1]) : 1000000;
+	int steps = argc > 2 ? atoi(argv[2]) : 200;
+
+	std::cout << std::fixed << std::setprecision(3);
+	bool same = checkSamePath(5000);
+
+	DuckSystem system;
+	fillSystem(system, ducks);
+	std::vector<double> systemMs;
+	for (int step = 0; step < steps; step++)
+	{
+		Clock::time_point start = Clock::now();
+		system.animate(true);
+		systemMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+	}
+
+	std::vector<DuckTarget> objects;
+	fillObjects(objects, ducks);
+	std::vector<double> objectMs;
+	for (int step = 0; step < steps; step++)
+	{
+		Clock::time_point start = Clock::now();
+		for (int i = 0; i < ducks; i++)
+			objects[i].animate(true);
+		objectMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+	}
+
+	report("DuckSystem", systemMs, ducks);
+	report("DuckTarget", objectMs, ducks);
+	return same ? 0 : 1;
+}
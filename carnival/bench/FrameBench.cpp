@@ -0,0 +1,454 @@
+///////////////////////////////////////////////////////////////////////////////
+// FrameBench.cpp
+// ==============
+// Draws the carnival scene offscreen for a fixed number of frames per scenario and
+// writes frame time percentiles as CSV and JSON. Each scenario raises one load (ducks,
+// bullets in flight, ground grid, water segments) over a light baseline, so the
+// numbers of two builds can be compared scenario by scenario.
+//
+// Rendering goes through Mesa's software rasterizer (llvmpipe) on a surfaceless EGL
+// context, no window or GPU needed. Frames are drawn by Scene::draw(), the passes
+// displayCB runs (ground, ducks, gun and bullets, booth, water, skybox, laser), with
+// the game's camera and light; textures are a generated checker and the HUD is left out.
+// Every frame runs one simulation tick with the headless driver's sweep-and-fire
+// input and ends with glFinish(), so its time covers the rasterizing too.
+//
+// usage: FrameBench [frames=120] [csv=frame_bench.csv] [json=frame_bench.json] [filter]
+//
+// frames is a whole number from 1 to 1000000, filter runs only the scenarios whose
+// name contains it (one has to match)
+///////////////////////////////////////////////////////////////////////////////
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <ctime>
+#include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+
+#define FREEGLUT_STATIC
+#include <GL/freeglut.h>
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include "Matrices.h"
+#include "MatrixStack.h"
+#include "Renderer.h"
+
+#include "CubeMesh.h"
+#include "Gun.h"
+#include "Simulation.h"
+#include "Scene.h"
+
+typedef std::chrono::steady_clock Clock;
+
+// same as the game
+static const int SCREEN_WIDTH = 900;
+static const int SCREEN_HEIGHT = 600;
+static const float CAMERA_DISTANCE = 24.0f;
+static const double TICK_SECONDS = 0.01;
+static const float LANE_SPACING = 4.0f;
+
+// frames drawn before the timed ones (shader compiles, first uploads)
+static const int WARMUP_FRAMES = 10;
+
+struct Scenario
+{
+	const char* name;
+	int ducks;				// six per lane
+	int bullets;			// kept in flight
+	int meshSize;			// ground quads per side
+	int waveSegments;
+};
+
+// the baseline is the game's own load (ground 16, six ducks) so the load a scenario raises is what its time shows
+static const Scenario SCENARIOS[] =
+{
+	{ "baseline",     6,     1,   16, SINE_WAVE_SEGMENTS },
+	{ "ducks_600",    600,   1,   16, SINE_WAVE_SEGMENTS },
+	{ "ducks_60000",  60000, 1,   16, SINE_WAVE_SEGMENTS },
+	{ "bullets_100",  6,     100, 16, SINE_WAVE_SEGMENTS },
+	{ "ground_64",    6,     1,   64, SINE_WAVE_SEGMENTS },
+	{ "ground_256",   6,     1,   256, SINE_WAVE_SEGMENTS },
+	{ "ground_1024",  6,     1,   1024, SINE_WAVE_SEGMENTS },
+	{ "water_4000",   6,     1,   16, 4000 },
+	{ "water_40000",  6,     1,   16, 40000 },
+};
+
+struct Result
+{
+	const Scenario* scenario;
+	int frames;
+	double min, avg, p50, p90, p95, p99, max;	// milliseconds
+	int drawCalls;			// of the last frame
+	int triangles;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// offscreen context: surfaceless EGL display, core 3.3 context, one FBO
+///////////////////////////////////////////////////////////////////////////////
+static bool createContext()
+{
+	// Mesa's rasterizer even where a GPU driver exists, unless the caller chose otherwise
+	setenv("LIBGL_ALWAYS_SOFTWARE", "1", 0);
+
+	PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+		(PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+	if (!getPlatformDisplay)
+	{
+		std::cerr << "EGL has no eglGetPlatformDisplayEXT" << std::endl;
+		return false;
+	}
+	EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+	EGLint major, minor;
+	if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor) || !eglBindAPI(EGL_OPENGL_API))
+	{
+		std::cerr << "no surfaceless EGL display (needs Mesa)" << std::endl;
+		return false;
+	}
+
+	const EGLint configAttribs[] = { EGL_SURFACE_TYPE, EGL_PBUFFER_BIT, EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_NONE };
+	EGLConfig config;
+	EGLint configs = 0;
+	eglChooseConfig(display, configAttribs, &config, 1, &configs);
+	const EGLint contextAttribs[] =
+	{
+		EGL_CONTEXT_MAJOR_VERSION, 3,
+		EGL_CONTEXT_MINOR_VERSION, 3,
+		EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+		EGL_NONE
+	};
+	EGLContext context = configs > 0 ? eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttribs) : EGL_NO_CONTEXT;
+	if (context == EGL_NO_CONTEXT || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context))
+	{
+		std::cerr << "cannot create a GL 3.3 core context" << std::endl;
+		return false;
+	}
+
+	// GLEW looks for GLX after loading the GL entry points, there is none on an EGL context
+	glewExperimental = GL_TRUE;
+	GLenum glewResult = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+	if (glewResult == GLEW_ERROR_NO_GLX_DISPLAY)
+		glewResult = GLEW_OK;
+#endif
+	if (glewResult != GLEW_OK)
+	{
+		std::cerr << "glewInit failed" << std::endl;
+		return false;
+	}
+	glGetError();
+
+	GLuint fbo, renderbuffers[2];
+	glGenFramebuffers(1, &fbo);
+	glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+	glGenRenderbuffers(2, renderbuffers);
+	glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[0]);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, SCREEN_WIDTH, SCREEN_HEIGHT);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffers[0]);
+	glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[1]);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, SCREEN_WIDTH, SCREEN_HEIGHT);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, renderbuffers[1]);
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+	{
+		std::cerr << "offscreen framebuffer incomplete" << std::endl;
+		return false;
+	}
+
+	// same state as initGL()
+	glViewport(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT);
+	glEnable(GL_DEPTH_TEST);
+	glEnable(GL_CULL_FACE);
+	glEnable(GL_PROGRAM_POINT_SIZE);
+	glClearColor(0.02f, 0.02f, 0.1f, 1.0f);
+	glClearStencil(0);
+	glClearDepth(1.0f);
+	glDepthFunc(GL_LEQUAL);
+	return true;
+}
+
+static const int CHECKER_SIZE = 64;
+
+static void fillChecker(std::vector<unsigned char>& pixels)
+{
+	pixels.resize(CHECKER_SIZE * CHECKER_SIZE * 3);
+	for (int y = 0; y < CHECKER_SIZE; y++)
+		for (int x = 0; x < CHECKER_SIZE; x++)
+		{
+			unsigned char value = ((x / 8 + y / 8) & 1) ? 230 : 40;
+			unsigned char* pixel = &pixels[(y * CHECKER_SIZE + x) * 3];
+			pixel[0] = pixel[1] = pixel[2] = value;
+		}
+}
+
+// stands in for the booth and ground images
+static GLuint createCheckerTexture()
+{
+	std::vector<unsigned char> pixels;
+	fillChecker(pixels);
+
+	GLuint texture;
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, CHECKER_SIZE, CHECKER_SIZE, 0, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+	glGenerateMipmap(GL_TEXTURE_2D);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	return texture;
+}
+
+// stands in for the skybox images, the same checker on every face
+static GLuint createCheckerCubemap()
+{
+	std::vector<unsigned char> pixels;
+	fillChecker(pixels);
+
+	GLuint texture;
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_CUBE_MAP, texture);
+	for (int face = 0; face < 6; face++)
+		glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, GL_RGB8, CHECKER_SIZE, CHECKER_SIZE, 0, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+	glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+	return texture;
+}
+
+// toPerspective(): 60 degrees, near 0.2, far 100
+static Matrix4 perspective()
+{
+	const float N = 0.2f;
+	const float F = 100.0f;
+	const float FOV_Y = 60.0f * 3.141592f / 180;
+
+	float h = N * tanf(FOV_Y / 2.0f);
+	float w = h * SCREEN_WIDTH / SCREEN_HEIGHT;
+	Matrix4 projection;
+	projection[0] = N / w;
+	projection[5] = N / h;
+	projection[10] = -(F + N) / (F - N);
+	projection[11] = -1;
+	projection[14] = -(2 * F * N) / (F - N);
+	projection[15] = 0;
+	return projection;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// nearest rank, samples sorted
+///////////////////////////////////////////////////////////////////////////////
+static double percentile(const std::vector<double>& sorted, double p)
+{
+	int count = (int)sorted.size();
+	int rank = (int)(p * count + 0.5);
+	return sorted[std::min(std::max(rank, 1), count) - 1];
+}
+
+static Result runScenario(const Scenario& scenario, int frames, const Scene::Textures& textures)
+{
+	Renderer renderer;
+	renderer.initGLSL();
+	renderer.setViewport(SCREEN_WIDTH, SCREEN_HEIGHT);
+	GLfloat lightKa[] = { .05f, .05f, .05f, 1.0f };
+	GLfloat lightKd[] = { 0.7f, 0.8f, 1.0f, 1.0f };
+	GLfloat lightKs[] = { 1, 1, 1, 1 };
+	float lightPos[4] = { -4.0, 8.0f, 8.0f, 1.0f };
+	renderer.setLight(lightPos, lightKa, lightKd, lightKs);
+
+	// room for every bullet the scenario keeps in flight
+	Simulation simulation(TICK_SECONDS, std::max(64, scenario.bullets));
+	simulation.setupGallery(std::max(1, scenario.ducks / 6), LANE_SPACING);
+
+	Scene scene(scenario.meshSize, scenario.waveSegments);
+	scene.initGLSL(renderer);
+	scene.setTextures(textures);
+
+	MatrixStack skyView;
+	skyView.lookAt(Vector3(0, 0, 0), Vector3(0.0f, 2.0f, CAMERA_DISTANCE), Vector3(0, 1, 0));
+	MatrixStack view;
+	view.lookAt(Vector3(0.0f, 2.0f, CAMERA_DISTANCE), Vector3(0.0f, 2.0f, 0.0f), Vector3(0, 1, 0));
+	Matrix4 projection = perspective();
+
+	Result result = {};
+	result.scenario = &scenario;
+	result.frames = frames;
+	std::vector<double> samples;
+	samples.reserve(frames);
+
+	for (int frame = 0; frame < WARMUP_FRAMES + frames; frame++)
+	{
+		// sweep and fire like HeadlessSim, topped up to the scenario's bullets
+		long long tick = simulation.getTicks();
+		simulation.moveGun(0.02f * cosf(tick * 0.01f), 0.0f);
+		while (simulation.getGun().getBulletCount() < scenario.bullets && simulation.shoot())
+			;
+		simulation.tick();
+
+		Clock::time_point start = Clock::now();
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+		scene.draw(renderer, simulation, view.top(), skyView.top(), projection, 1.0f, NULL);
+
+		// what swapping would wait for
+		glFinish();
+		double milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		if (frame >= WARMUP_FRAMES)
+			samples.push_back(milliseconds);
+	}
+
+	// every pass of the last frame, the water, skybox and laser included
+	result.drawCalls = renderer.getDrawCalls();
+	result.triangles = renderer.getTriangles();
+
+	std::sort(samples.begin(), samples.end());
+	double sum = 0.0;
+	for (size_t i = 0; i < samples.size(); i++)
+		sum += samples[i];
+	result.min = samples.front();
+	result.avg = sum / samples.size();
+	result.p50 = percentile(samples, 0.50);
+	result.p90 = percentile(samples, 0.90);
+	result.p95 = percentile(samples, 0.95);
+	result.p99 = percentile(samples, 0.99);
+	result.max = samples.back();
+	return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// output
+///////////////////////////////////////////////////////////////////////////////
+static bool writeCsv(const char* fileName, const std::vector<Result>& results)
+{
+	std::ofstream file(fileName);
+	if (!file)
+		return false;
+	file << "scenario,ducks,bullets,ground,water_segments,frames,min_ms,avg_ms,p50_ms,p90_ms,p95_ms,p99_ms,max_ms,draw_calls,triangles\n";
+	file << std::fixed << std::setprecision(3);
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const Result& r = results[i];
+		const Scenario& s = *r.scenario;
+		file << s.name << ',' << s.ducks << ',' << s.bullets << ',' << s.meshSize << ',' << s.waveSegments << ','
+			 << r.frames << ',' << r.min << ',' << r.avg << ',' << r.p50 << ',' << r.p90 << ',' << r.p95 << ','
+			 << r.p99 << ',' << r.max << ',' << r.drawCalls << ',' << r.triangles << '\n';
+	}
+	return (bool)file;
+}
+
+static bool writeJson(const char* fileName, const std::vector<Result>& results, const char* glRenderer)
+{
+	std::ofstream file(fileName);
+	if (!file)
+		return false;
+	file << std::fixed << std::setprecision(3);
+	file << "{\n  \"renderer\": \"";
+	// driver strings are plain text, only quotes and backslashes need escaping
+	for (const char* c = glRenderer; *c; c++)
+	{
+		if (*c == '"' || *c == '\\')
+			file << '\\';
+		file << *c;
+	}
+	file << "\",\n  \"width\": " << SCREEN_WIDTH << ",\n  \"height\": " << SCREEN_HEIGHT << ",\n  \"scenarios\": [";
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const Result& r = results[i];
+		const Scenario& s = *r.scenario;
+		file << (i ? ",\n" : "\n")
+			 << "    { \"name\": \"" << s.name << "\", \"ducks\": " << s.ducks << ", \"bullets\": " << s.bullets
+			 << ", \"ground\": " << s.meshSize << ", \"water_segments\": " << s.waveSegments << ", \"frames\": " << r.frames
+			 << ",\n      \"ms\": { \"min\": " << r.min << ", \"avg\": " << r.avg << ", \"p50\": " << r.p50
+			 << ", \"p90\": " << r.p90 << ", \"p95\": " << r.p95 << ", \"p99\": " << r.p99 << ", \"max\": " << r.max
+			 << " },\n      \"draw_calls\": " << r.drawCalls << ", \"triangles\": " << r.triangles << " }";
+	}
+	file << "\n  ]\n}\n";
+	return (bool)file;
+}
+
+static int usage()
+{
+	std::cerr << "usage: FrameBench [frames=120] [csv=frame_bench.csv] [json=frame_bench.json] [filter]" << std::endl;
+	return 1;
+}
+
+int main(int argc, char** argv)
+{
+	long frames = 120;
+	if (argc > 1)
+	{
+		// a whole number of frames and nothing else
+		char* end;
+		frames = strtol(argv[1], &end, 10);
+		if (end == argv[1] || *end != '\0' || frames < 1 || frames > 1000000)
+			return usage();
+	}
+	if (argc > 5)
+		return usage();
+	const char* csvFile = argc > 2 ? argv[2] : "frame_bench.csv";
+	const char* jsonFile = argc > 3 ? argv[3] : "frame_bench.json";
+	const char* filter = argc > 4 ? argv[4] : "";
+
+	int matching = 0;
+	for (size_t i = 0; i < sizeof(SCENARIOS) / sizeof(SCENARIOS[0]); i++)
+		matching += strstr(SCENARIOS[i].name, filter) ? 1 : 0;
+	if (matching == 0)
+	{
+		std::cerr << "no scenario matches " << filter << ", nothing written" << std::endl;
+		return 1;
+	}
+
+	if (!createContext())
+		return 1;
+	const char* glRenderer = (const char*)glGetString(GL_RENDERER);
+	std::cout << "renderer " << glRenderer << ", " << frames << " frames per scenario" << std::endl;
+
+	CubeMesh::CreateMeshVBO();
+	GLuint texture = createCheckerTexture();
+	GLuint skyTexture = createCheckerCubemap();
+	Scene::Textures textures = { texture, texture, texture, texture, skyTexture };
+
+	std::cout << std::left << std::setw(14) << "scenario" << std::right
+			  << std::setw(10) << "avg ms" << std::setw(10) << "p50" << std::setw(10) << "p90"
+			  << std::setw(10) << "p99" << std::setw(10) << "max" << std::setw(8) << "draws"
+			  << std::setw(12) << "triangles" << std::endl;
+	std::cout << std::fixed << std::setprecision(2);
+
+	std::vector<Result> results;
+	for (size_t i = 0; i < sizeof(SCENARIOS) / sizeof(SCENARIOS[0]); i++)
+	{
+		if (!strstr(SCENARIOS[i].name, filter))
+			continue;
+		Result r = runScenario(SCENARIOS[i], (int)frames, textures);
+		results.push_back(r);
+		std::cout << std::left << std::setw(14) << SCENARIOS[i].name << std::right
+				  << std::setw(10) << r.avg << std::setw(10) << r.p50 << std::setw(10) << r.p90
+				  << std::setw(10) << r.p99 << std::setw(10) << r.max << std::setw(8) << r.drawCalls
+				  << std::setw(12) << r.triangles << std::endl;
+	}
+
+	glDeleteTextures(1, &texture);
+	glDeleteTextures(1, &skyTexture);
+	CubeMesh::DeleteMeshVBO();
+
+	if (glGetError() != GL_NO_ERROR)
+		std::cerr << "GL error during the run" << std::endl;
+	if (!writeCsv(csvFile, results) || !writeJson(jsonFile, results, glRenderer))
+	{
+		std::cerr << "cannot write " << csvFile << " or " << jsonFile << std::endl;
+		return 1;
+	}
+	std::cout << "results written to " << csvFile << " and " << jsonFile << std::endl;
+	return 0;
+}
@@ -0,0 +1,126 @@
+///////////////////////////////////////////////////////////////////////////////
+// TargetGridBench.cpp
+// ===================
+// Bullet vs. target queries through the TargetGrid broadphase compared with
+// testing every bullet against every duck, and checks both find the same hits.
+//
+// usage: TargetGridBench [targets] [bullets] [reps]
+///////////////////////////////////////////////////////////////////////////////
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+
+#include "Vectors.h"
+#include "Matrices.h"
+#include "DuckSystem.h"
+#include "TargetGrid.h"
+
+typedef std::chrono::steady_clock Clock;
+
+static float randomRange(float lo, float hi)
+{
+	return lo + (hi - lo) * (rand() / (float)RAND_MAX);
+}
+
+static double elapsedMs(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// six ducks per lane like the gallery, spread over the track instead of the fixed start spots
+static void fillSystem(DuckSystem& system, int count)
+{
+	system.reserve(count);
+	for (int i = 0; i < count; i++)
+		system.addDuck(randomRange(-8.0f, 8.0f), (i % 6) >= 3, -8.0f - 4.0f * (i / 6));
+	system.updateTargetCoords();
+}
+
+// one tick of bullet travel (0.8 down z), half of them aimed at a duck so there are hits to find
+static void fillBullets(const DuckSystem& system, int count, std::vector<Vector3>& from, std::vector<Vector3>& to)
+{
+	float minZ = -8.0f - 4.0f * (system.size() / 6) - 2.0f;
+	for (int i = 0; i < count; i++)
+	{
+		Vector3 start;
+		if (i % 2 == 0)
+		{
+			Vector3 target = system.getTargetCoords(rand() % system.size());
+			start = Vector3(target.x + randomRange(-1.0f, 1.0f), target.y + randomRange(-1.0f, 1.0f), target.z + randomRange(-0.5f, 1.5f));
+		}
+		else
+		{
+			start = Vector3(randomRange(-9.0f, 9.0f), randomRange(-2.0f, 1.0f), randomRange(minZ, 0.0f));
+		}
+		from.push_back(start);
+		to.push_back(Vector3(start.x, start.y, start.z - 0.8f));
+	}
+}
+
+int main(int argc, char** argv)
+{
+	int targets = argc > 1 ? atoi(argv[1]) : 10000;
+	int bullets = argc > 2 ? atoi(argv[2]) : 1000;
+	int reps = argc > 3 ? atoi(argv[3]) : 50;
+	srand(1);
+
+	DuckSystem system;
+	fillSystem(system, targets);
+	std::vector<Vector3> from, to;
+	fillBullets(system, bullets, from, to);
+
+	TargetGrid grid;
+	std::vector<int> candidates;
+	candidates.reserve(targets);
+
+	double buildMs = 0.0, gridMs = 0.0, bruteMs = 0.0;
+	long gridHits = 0, bruteHits = 0, tested = 0;
+	bool same = true;
+	for (int rep = 0; rep < reps; rep++)
+	{
+		Clock::time_point start = Clock::now();
+		grid.build(system);
+		buildMs += elapsedMs(start);
+
+		// broadphase + narrow phase, hits counted as a checksum per bullet
+		std::vector<int> perBulletGrid(bullets, 0);
+		start = Clock::now();
+		for (int b = 0; b < bullets; b++)
+		{
+			candidates.clear();
+			grid.query(from[b], to[b], system.getTargetRadius(), DuckSystem::getTargetDepth(), candidates);
+			tested += candidates.size();
+			for (size_t k = 0; k < candidates.size(); k++)
+				if (system.hit(candidates[k], from[b], to[b]))
+					perBulletGrid[b] += candidates[k] + 1;
+		}
+		gridMs += elapsedMs(start);
+
+		std::vector<int> perBulletBrute(bullets, 0);
+		start = Clock::now();
+		for (int b = 0; b < bullets; b++)
+			for (int d = 0; d < targets; d++)
+				if (system.hit(d, from[b], to[b]))
+					perBulletBrute[b] += d + 1;
+		bruteMs += elapsedMs(start);
+
+		for (int b = 0; b < bullets; b++)
+		{
+			gridHits += perBulletGrid[b] != 0;
+			bruteHits += perBulletBrute[b] != 0;
+			same = same && perBulletGrid[b] == perBulletBrute[b];
+		}
+	}
+
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << targets << " targets, " << bullets << " bullets, grid " << grid.getCellsX() << " x " << grid.getCellsZ() << " cells" << std::endl;
+	std::cout << "bullets with hits: grid " << gridHits / reps << ", brute force " << bruteHits / reps
+		<< (same ? " (same ducks)" : " (MISMATCH)") << std::endl;
+	std::cout << "candidates per bullet " << (double)tested / ((double)reps * bullets) << std::endl;
+	std::cout << "grid build      " << std::setw(9) << buildMs / reps << " ms" << std::endl;
+	std::cout << "grid queries    " << std::setw(9) << gridMs / reps << " ms  " << gridMs * 1.0e6 / ((double)reps * bullets) << " ns/bullet" << std::endl;
+	std::cout << "brute force     " << std::setw(9) << bruteMs / reps << " ms  " << bruteMs * 1.0e6 / ((double)reps * bullets) << " ns/bullet" << std::endl;
+	return same ? 0 : 1;
+}
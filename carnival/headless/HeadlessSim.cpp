@@ -0,0 +1,221 @@
+///////////////////////////////////////////////////////////////////////////////
+// HeadlessSim.cpp
+// ===============
+// Runs the carnival simulation without a window or GL context and reports
+// throughput. Input comes from a script (or a built-in sweep-and-fire pattern)
+// keyed by simulation tick, so two runs with the same arguments do the same thing.
+// A binary input log (the game's --record, or record file here) is replayed as fast
+// as it runs and its hits are checked against the recorded ones, tick by tick; with a
+// record file as well, the replayed inputs and the hits they make are written to it.
+//
+// usage: HeadlessSim [ticks=100000] [lanes=1] [script|-|input log] [record file]
+//
+// script lines: <tick> shoot
+//               <tick> move <dx> <dy>
+//               <tick> moving <0|1>
+//               # comment
+//
+// ticks and lanes are positive whole numbers, at most Simulation::MAX_LANES lanes.
+// Script - is the built-in pattern, an input log brings its own gallery and ticks 0
+// replays all of it.
+///////////////////////////////////////////////////////////////////////////////
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include "Vectors.h"
+#include "Matrices.h"
+#include "Simulation.h"
+#include "InputLog.h"
+
+typedef std::chrono::steady_clock Clock;
+
+// same tick the game runs at
+static const double TICK_SECONDS = 0.01;
+
+static bool loadScript(const char* path, std::vector<InputLog::Input>& events)
+{
+	std::ifstream file(path);
+	if (!file)
+	{
+		std::cerr << "cannot open script " << path << std::endl;
+		return false;
+	}
+
+	std::string line;
+	int lineNumber = 0;
+	while (std::getline(file, line))
+	{
+		lineNumber++;
+		if (line.empty() || line[0] == '#')
+			continue;
+
+		std::istringstream in(line);
+		InputLog::Input event = { 0, InputLog::SHOOT, 0.0f, 0.0f };
+		std::string command;
+		in >> event.tick >> command;
+		if (command == "shoot")
+			event.type = InputLog::SHOOT;
+		else if (command == "move" && (in >> event.x >> event.y))
+			event.type = InputLog::MOVE;
+		else if (command == "moving" && (in >> event.x))
+			event.type = InputLog::MOVING;
+		else
+		{
+			std::cerr << path << ":" << lineNumber << ": bad line: " << line << std::endl;
+			return false;
+		}
+		events.push_back(event);
+	}
+	return true;
+}
+
+static int usage()
+{
+	std::cerr << "usage: HeadlessSim [ticks=100000] [lanes=1] [script|-|input log] [record file]" << std::endl;
+	return 1;
+}
+
+// a whole decimal number and nothing else
+static bool parseCount(const char* text, long long& value)
+{
+	char* end;
+	value = strtoll(text, &end, 10);
+	return end != text && *end == '\0';
+}
+
+// without a script: sweep the gun left and right and fire every 25 ticks
+static void builtinInput(long long tick, std::vector<InputLog::Input>& tickInputs)
+{
+	InputLog::Input move = { tick, InputLog::MOVE, 0.02f * cosf(tick * 0.01f), 0.0f };
+	tickInputs.push_back(move);
+	if (tick % 25 == 0)
+	{
+		InputLog::Input shoot = { tick, InputLog::SHOOT, 0.0f, 0.0f };
+		tickInputs.push_back(shoot);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	long long ticks = 100000;
+	long long laneCount = 1;
+	if (argc > 5 || (argc > 1 && !parseCount(argv[1], ticks)) || (argc > 2 && !parseCount(argv[2], laneCount)))
+		return usage();
+	const char* recordFile = argc > 4 ? argv[4] : NULL;
+
+	// the input either comes from a recorded log, a text script or the built-in pattern
+	InputLog replayLog;
+	bool scripted = argc > 3 && strcmp(argv[3], "-") != 0;
+	bool replaying = scripted && InputLog::isInputLog(argv[3]);
+	// ticks 0 only means something for a log, it replays the whole session
+	if (ticks < (replaying ? 0 : 1) || laneCount < 1 || laneCount > Simulation::MAX_LANES)
+		return usage();
+	int lanes = (int)laneCount;
+	std::vector<InputLog::Input> events;
+	if (replaying)
+	{
+		if (!replayLog.load(argv[3]))
+		{
+			std::cerr << "cannot read input log " << argv[3] << std::endl;
+			return 1;
+		}
+		if (replayLog.getTickSeconds() != TICK_SECONDS)
+			std::cerr << "input log was recorded with " << replayLog.getTickSeconds() << " s ticks" << std::endl;
+		lanes = replayLog.getLanes();
+		if (ticks <= 0)
+			ticks = replayLog.getTicks();
+		if (ticks <= 0)
+		{
+			std::cerr << "input log " << argv[3] << " has no ticks" << std::endl;
+			return 1;
+		}
+	}
+	else if (scripted && !loadScript(argv[3], events))
+		return 1;
+
+	Simulation simulation(TICK_SECONDS);
+	simulation.setupGallery(lanes);
+
+	InputLog recordLog;
+	recordLog.start(TICK_SECONDS, lanes);
+
+	std::vector<InputLog::Input> tickInputs;
+	size_t nextEvent = 0;
+	Clock::time_point start = Clock::now();
+	for (long long tick = 0; tick < ticks; tick++)
+	{
+		tickInputs.clear();
+		if (replaying)
+			replayLog.replay(simulation, &tickInputs);
+		else
+		{
+			if (events.empty())
+				builtinInput(tick, tickInputs);
+
+			// script events for this tick, in file order
+			while (nextEvent < events.size() && events[nextEvent].tick <= tick)
+				tickInputs.push_back(events[nextEvent++]);
+
+			for (size_t i = 0; i < tickInputs.size(); i++)
+				InputLog::apply(simulation, tickInputs[i]);
+		}
+
+		// whatever drove this tick, a replay included, goes into the record file
+		if (recordFile)
+		{
+			for (size_t i = 0; i < tickInputs.size(); i++)
+			{
+				tickInputs[i].tick = tick;
+				recordLog.record(tickInputs[i]);
+			}
+		}
+
+		simulation.tick();
+
+		if (replaying)
+			replayLog.checkHits(simulation);
+		if (recordFile)
+			recordLog.recordTick(simulation);
+	}
+	double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+	std::cout << std::fixed << std::setprecision(1);
+	std::cout << "ticks       " << simulation.getTicks() << " (" << simulation.getTicks() * TICK_SECONDS << " s simulated)" << std::endl;
+	std::cout << "ducks       " << simulation.getDucks().size() << std::endl;
+	std::cout << "shots       " << simulation.getShotsFired() << std::endl;
+	std::cout << "hits        " << simulation.getTotalHits() << std::endl;
+	std::cout << "wall time   " << std::setprecision(3) << seconds * 1000.0 << " ms" << std::endl;
+	std::cout << "ticks/s     " << std::setprecision(0) << ticks / seconds << std::endl;
+	std::cout << "ns/tick     " << std::setprecision(1) << seconds * 1.0e9 / ticks << std::endl;
+
+	if (recordFile)
+	{
+		if (!recordLog.save(recordFile))
+		{
+			std::cerr << "cannot write input log " << recordFile << std::endl;
+			return 1;
+		}
+		std::cout << "recorded    " << recordLog.getInputCount() << " inputs, " << recordLog.getHitCount() << " hits to " << recordFile << std::endl;
+	}
+	if (replaying)
+	{
+		if (!replayLog.hitsMatch())
+		{
+			if (replayLog.getMismatchTick() >= 0)
+				std::cout << "replay      hits differ from the recording from tick " << replayLog.getMismatchTick() << std::endl;
+			else
+				std::cout << "replay      stopped before all recorded hits" << std::endl;
+			return 2;
+		}
+		std::cout << "replay      " << replayLog.getHitCount() << " hits match the recording" << std::endl;
+	}
+	return 0;
+}
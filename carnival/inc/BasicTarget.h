@@ -39,9 +39,9 @@ private:
 public:
 
 	BasicTarget();
-	void BasicTarget::draw();
-	void BasicTarget::animate(bool wave);
-	void BasicTarget::flip();
+	void draw();
+	void animate(bool wave);
+	void flip();
 };
 
 
@@ -1,24 +0,0 @@
-class Gun {
-private:
-	float bulletX = 0;
-	float bulletY = -1.5;
-	float bulletZ = 9.5;
-
-	// Material properties for drawing
-	float bullet_ambient[4] = { 0.878f, 0.129f, 0.153f, 1.0f };
-	float bullet_diffuse[4] = { 0.878f, 0.129f, 0.153f, 1.0f };
-	float bullet_specular[4] = { 0.5f, 0.5f, 0.5f, 1.0f };
-	float bullet_shininess[1] = { 100.0F };
-
-public:
-	// constructor
-
-	// move bullet 
-
-	// checks if bullet hits given coords
-
-	// destructor for once bullet hits end of path 
-};
-
-
-
@@ -0,0 +1,55 @@
+#ifndef BULLET_POOL_H
+#define BULLET_POOL_H
+
+#include <vector>
+
+// Fixed number of bullet slots stored as arrays. Slots are handed out from a free list
+// and returned to it when a bullet reaches its max distance, so firing never allocates.
+// Live slots are also kept packed in one array so a tick only walks the bullets in flight.
+class BulletPool
+{
+private:
+	int capacity;
+
+	// per slot: gun pose when fired and distance travelled along the barrel
+	std::vector<float> originX;
+	std::vector<float> originY;
+	std::vector<float> angle;
+	std::vector<float> trajectory;
+	std::vector<float> lastTrajectory;		// trajectory before the last step()
+
+	// free slots as a stack
+	std::vector<int> freeSlots;
+	int freeCount;
+
+	// packed live slots, livePosition[slot] is the slot's index in liveSlots
+	std::vector<int> liveSlots;
+	std::vector<int> livePosition;
+	int liveCount;
+
+	void release(int slot);
+
+public:
+	BulletPool(int capacity = 64);
+
+	// take a free slot for a bullet leaving a gun at (x, y) turned by angle, -1 when all are in flight
+	int fire(float x, float y, float angle);
+
+	// move every live bullet by distance, bullets past maxDistance go back to the free list
+	void step(float distance, float maxDistance);
+
+	void clear();
+
+	int getCapacity() const { return capacity; }
+	int getLiveCount() const { return liveCount; }
+	// slot of the i-th live bullet
+	int getLiveSlot(int i) const { return liveSlots[i]; }
+
+	float getOriginX(int slot) const { return originX[slot]; }
+	float getOriginY(int slot) const { return originY[slot]; }
+	float getAngle(int slot) const { return angle[slot]; }
+	float getTrajectory(int slot) const { return trajectory[slot]; }
+	float getLastTrajectory(int slot) const { return lastTrajectory[slot]; }
+};
+
+#endif
@@ -1,9 +1,14 @@
+class Renderer;
+
+// Unit cube (width 2, centered at the origin) with per-face normals and texture
+// coordinates. The geometry lives in one VBO/IBO shared by every CubeMesh, so each
+// booth piece is a single indexed draw with its own material and model matrix.
 class CubeMesh
 {
 private:
-	GLfloat (*vertices)[3];
-	GLfloat (*quadNormals)[3];
-	GLubyte (*quads)[4];
+	// shared by all cubes, built once by CreateMeshVBO()
+	static GLuint vao;
+	static GLuint vbos[2];
 
 	// Material properties for drawing
 	float mat_ambient[4];
@@ -18,8 +23,15 @@ public:
 	typedef std::pair<int, int> MaxMeshDim;
 	
 	CubeMesh();
-	void CubeMesh::drawCubeMesh();
-	void CubeMesh::setMaterial(Vector3 ambient, Vector3 diffuse, Vector3 specular, double shininess);
+
+	// upload the shared cube once, needs a current GL context
+	static void CreateMeshVBO();
+	static void DeleteMeshVBO();
+
+	// one indexed draw with the cube's material and the given model matrix,
+	// nothing when the transformed cube is outside the renderer's frustum
+	void drawCubeMesh(Renderer& renderer, const Matrix4& model);
+	void setMaterial(Vector3 ambient, Vector3 diffuse, Vector3 specular, double shininess);
 };
 
 
@@ -0,0 +1,91 @@
+#ifndef DUCK_BATCH_H
+#define DUCK_BATCH_H
+
+#include <vector>
+
+#include "Matrices.h"
+#include "MeshLod.h"
+
+class DuckMesh;
+class DuckSystem;
+class Renderer;
+
+// Draws every duck with one glDrawElementsInstanced per duck part.
+// Per-instance values (duckX, duckY, duckZ, spin, flipAngle) are streamed from the
+// DuckSystem draw arrays (interpolated between ticks) into an instance buffer each frame and the duck transform chain is
+// rebuilt in the vertex shader, so the number of draw calls does not grow with the
+// number of ducks.
+// Ducks are bucketed by level of detail (MeshLod) from their size on screen; the
+// buckets sit one after the other in the instance buffer and each one is drawn with
+// the matching tessellation of the mesh. Ducks outside the renderer's frustum are
+// left out of the buffer.
+class DuckBatch
+{
+private:
+	DuckMesh* mesh;
+
+	GLuint progId;
+	GLuint vao;
+	GLuint instanceVBO;
+	int instanceCapacity;				// ducks that fit in instanceVBO
+
+	// instance streams reordered by level, and the level of each duck
+	std::vector<float> instanceData;
+	std::vector<unsigned char> duckLevels;
+	int levelInstances[MeshLod::LEVELS];	// ducks drawn at each level by the last draw()
+	int culled;							// ducks the last draw() left out
+
+	// transform of each part (body, bullseye, neck, head, beak, tail) relative to the duck
+	Matrix4 bodyMatrix;
+	Matrix4 bullseyeMatrix;
+	Matrix4 neckMatrix;
+	Matrix4 headMatrix;
+	Matrix4 beakMatrix;
+	Matrix4 tailMatrix;
+
+	GLint uniformPartMatrix;
+	GLint uniformBullseye;
+	GLint uniformViewMatrix;
+	GLint uniformProjectionMatrix;
+	GLint uniformMaterialIndex;
+
+	// Material properties of the body and the beak
+	float mat_ambient[4] = { 0.957f, 0.74f, 0.047f, 1.0f };
+	float mat_diffuse[4] = { 0.957f, 0.74f, 0.047f, 1.0f };
+	float mat_specular[4] = { 0.5f, 0.5f, 0.5f, 1.0f };
+	float mat_shininess[1] = { 100.0F };
+
+	float beakmat_ambient[4] = { 0.878f, 0.129f, 0.153f, 1.0f };
+	float beakmat_diffuse[4] = { 0.878f, 0.129f, 0.153f, 1.0f };
+	float beakmat_specular[4] = { 0.5f, 0.5f, 0.5f, 1.0f };
+	float beakmat_shininess[1] = { 100.0F };
+
+	// their indices in the renderer's Materials block
+	int bodyMaterial;
+	int beakMaterial;
+
+private:
+	void reserveInstances(int count);
+	int addMaterial(Renderer& renderer, float* ambient, float* diffuse, float* specular, float* shininess);
+	int sortByLevel(const DuckSystem& ducks, const Renderer& renderer);
+	void drawPart(Renderer& renderer, int shape, int level, const Matrix4& partMatrix, bool bullseye, GLsizei instances);
+
+public:
+	DuckBatch(DuckMesh* mesh);
+	~DuckBatch();
+
+	// compile the instanced shader and build the VAO, needs a current GL context.
+	// The duck materials are added to the renderer's material table.
+	bool initGLSL(Renderer& renderer);
+
+	// camera comes from the renderer's current pass, light and materials from its uniform buffers;
+	// the draws and their triangles (every instance) go to the renderer's counts
+	void draw(const DuckSystem& ducks, Renderer& renderer);
+
+	// ducks the last draw() drew at a level of detail
+	int getLevelInstances(int level) { return levelInstances[level]; }
+	// ducks the last draw() skipped as off screen
+	int getCulled() { return culled; }
+};
+
+#endif
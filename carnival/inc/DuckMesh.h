@@ -0,0 +1,52 @@
+#ifndef DUCK_MESH_H
+#define DUCK_MESH_H
+
+#include <vector>
+
+#include "MeshLod.h"
+
+// Duck geometry for DuckBatch, shared by every duck.
+// Replaces the per-frame gluNewQuadric()/gluSphere()/gluCylinder() calls with one
+// vertex/index buffer that is built once; DuckBatch binds it into its instanced VAO.
+// Every part is built at MeshLod::LEVELS tessellations, level 0 is slices x stacks.
+class DuckMesh
+{
+public:
+	// unit sphere (body, bullseye, head) and the three gluCylinder shapes (neck, beak, tail)
+	enum Part { SPHERE = 0, NECK, BEAK, TAIL, PART_COUNT };
+
+private:
+	int slices;
+	int stacks;
+
+	// interleaved position (xyz) + normal (xyz)
+	std::vector<float> verticesVBO;
+	std::vector<unsigned int> indices;
+
+	// index range of each part and level inside the shared index buffer
+	unsigned int partOffset[MeshLod::LEVELS][PART_COUNT];
+	unsigned int partCount[MeshLod::LEVELS][PART_COUNT];
+
+	GLuint vbos[2];
+
+private:
+	void addVertex(float x, float y, float z, float nx, float ny, float nz);
+	void addSphere(Part part, int level, float radius);
+	void addCylinder(Part part, int level, float baseRadius, float topRadius, float height);
+
+public:
+	DuckMesh(int slices = 20, int stacks = 20);
+	~DuckMesh();
+
+	// upload geometry to the GPU, needs a current GL context
+	void CreateMeshVBO();
+
+	// point generic attributes of the currently bound VAO at the shared buffers
+	void setupAttributes(GLuint positionAttrib, GLuint normalAttrib);
+
+	void drawPartInstanced(Part part, int level, GLsizei instances);
+	// indices (3 per triangle) of a part at a level
+	unsigned int getPartCount(Part part, int level) const { return partCount[level][part]; }
+};
+
+#endif
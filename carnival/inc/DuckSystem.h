@@ -0,0 +1,102 @@
+#ifndef DUCK_SYSTEM_H
+#define DUCK_SYSTEM_H
+
+#include <vector>
+#include "Vectors.h"
+#include "Matrices.h"
+
+// All ducks of the gallery stored as structure-of-arrays.
+// animate() advances every duck with branch-free steps (same track as DuckTarget::animate),
+// four at a time with SSE2 (eight with AVX2); the arrays are handed to the renderer as they are.
+class DuckSystem
+{
+public:
+	// position of a duck on its loop around the track
+	enum State { LEFT_TO_RIGHT = 0, TURN1 = 1, RIGHT_TO_LEFT = 2, TURN2 = 3 };
+
+private:
+	std::vector<float> duckX;
+	std::vector<float> duckY;
+	std::vector<float> duckZ;
+	std::vector<float> spin;
+	std::vector<float> flipAngle;
+	std::vector<int> state;
+	std::vector<int> flipped;
+
+	// animated values before the last tick and the blend drawn between ticks
+	std::vector<float> prevX;
+	std::vector<float> prevY;
+	std::vector<float> prevSpin;
+	std::vector<float> prevFlipAngle;
+	std::vector<float> drawX;
+	std::vector<float> drawY;
+	std::vector<float> drawSpin;
+	std::vector<float> drawFlipAngle;
+
+	// bullseye center of every duck, refreshed by updateTargetCoords()
+	std::vector<float> targetX;
+	std::vector<float> targetY;
+	std::vector<float> targetZ;
+
+	// target radius for hit detection (0.2 * duck width, same as DuckTarget)
+	const float targetRadius = 0.8f;
+
+public:
+	DuckSystem();
+
+	// add a duck at x on the lane at depth z, flip starts it upside down going right to left
+	int addDuck(float x, bool flip = false, float z = -8.0f);
+	void reserve(int count);
+	void clear();
+	int size() const { return (int)duckX.size(); }
+
+	// one step of every duck around the track. steps scales the step for a tick that is
+	// not the 12 ms the ducks were tuned for (steps = tick seconds / getStepSeconds())
+	void animate(bool wave, float steps = 1.0f);
+	static float getStepSeconds();
+
+	// keep the current values as the start of the next tick, call before animate()
+	void savePrevious();
+	// blend previous and current values for drawing, alpha 0..1 between the two ticks
+	void interpolate(float alpha);
+
+	void flip(int duck);
+	bool isFlipped(int duck) const { return flipped[duck] != 0; }
+
+	// model transform of a whole duck, the chain DuckBatch rebuilds per instance
+	static Matrix4 modelMatrix(float x, float y, float z, float spin, float flipAngle);
+	Matrix4 getModelMatrix(int duck) const;
+
+	// sphere holding a duck at (x, y, z) whatever its spin and flip, for frustum culling
+	static Vector3 boundsCenter(float x, float y, float z);
+	static float getBoundsRadius();
+
+	// recompute bullseye positions from the transform chain (world space unless a view matrix is given)
+	void updateTargetCoords(const Matrix4& view = Matrix4());
+	Vector3 getTargetCoords(int duck) const { return Vector3(targetX[duck], targetY[duck], targetZ[duck]); }
+	bool hit(int duck, Vector3 bulletCoords) const;
+	// swept test over the path a bullet travelled in one step, no tunneling at any speed
+	bool hit(int duck, Vector3 from, Vector3 to) const;
+	static bool sweepTarget(Vector3 center, float radius, Vector3 from, Vector3 to);
+
+	// size of the hit volume around each bullseye (radius in x/y, half depth along z)
+	float getTargetRadius() const { return targetRadius; }
+	static float getTargetDepth();
+
+	// arrays for the renderer, the draw values are the ones from the last interpolate()
+	const float* getDrawX() const { return drawX.data(); }
+	const float* getDrawY() const { return drawY.data(); }
+	const float* getDrawSpin() const { return drawSpin.data(); }
+	const float* getDrawFlipAngle() const { return drawFlipAngle.data(); }
+	const float* getDuckX() const { return duckX.data(); }
+	const float* getDuckY() const { return duckY.data(); }
+	const float* getDuckZ() const { return duckZ.data(); }
+	const float* getSpin() const { return spin.data(); }
+	const float* getFlipAngle() const { return flipAngle.data(); }
+	const int* getState() const { return state.data(); }
+	const float* getTargetX() const { return targetX.data(); }
+	const float* getTargetY() const { return targetY.data(); }
+	const float* getTargetZ() const { return targetZ.data(); }
+};
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef FRAME_PROFILER_H
+#define FRAME_PROFILER_H
+
+#include "TimingHistory.h"
+
+class TraceRecorder;
+
+// Where a frame of displayCB goes, per pass. begin()/end() bracket a pass: its CPU
+// time comes from a steady clock, its GPU time from a GL_TIME_ELAPSED query. Queries
+// are read back QUERY_FRAMES frames later, so the CPU never waits for the GPU; a
+// result that is still not there by then is dropped instead. Passes must not nest
+// (one elapsed-time query at a time). With a TraceRecorder set, every pass also goes
+// into the trace.
+class FrameProfiler
+{
+public:
+	enum Pass { GROUND, DUCKS, GUN_BOOTH, WATER, SKYBOX, LASER, HUD, SWAP, PASS_COUNT };
+
+	// frames a query has to finish in before its slot is reused
+	static const int QUERY_FRAMES = 4;
+
+private:
+	GLuint queries[QUERY_FRAMES][PASS_COUNT];
+	bool issued[QUERY_FRAMES][PASS_COUNT];
+	int slot;					// query set of the current frame
+	bool gpuTiming;				// queries were created
+
+	int current;				// pass between begin() and end(), -1 outside
+	double cpuStart;
+
+	TimingHistory cpu[PASS_COUNT];
+	TimingHistory gpu[PASS_COUNT];
+	int droppedQueries;
+
+	TraceRecorder* trace;
+
+	void collect(int slot);
+
+public:
+	FrameProfiler();
+
+	// create the queries, needs a current GL context. Without it only CPU time is kept.
+	void init();
+	void release();
+	void setTrace(TraceRecorder* trace) { this->trace = trace; }
+
+	// at the start of displayCB: picks up the results of QUERY_FRAMES frames ago
+	void beginFrame();
+	void begin(Pass pass);
+	void end();
+
+	static const char* getName(Pass pass);
+	TimingHistory::Summary getCpu(Pass pass) const { return cpu[pass].summarize(); }
+	TimingHistory::Summary getGpu(Pass pass) const { return gpu[pass].summarize(); }
+	bool hasGpuTiming() const { return gpuTiming; }
+	int getDroppedQueries() const { return droppedQueries; }
+
+	// table of every pass, milliseconds
+	void print() const;
+	void reset();
+};
+
+#endif
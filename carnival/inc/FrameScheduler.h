@@ -0,0 +1,42 @@
+#ifndef FRAME_SCHEDULER_H
+#define FRAME_SCHEDULER_H
+
+// Redraw on demand. Anything that changes what is on screen calls requestRedraw();
+// requests are folded into one pending frame, and frameDue() lets it through at most
+// once per frame interval (1 / target fps). With nothing pending no frame is drawn.
+// Frame slots are kept on a fixed grid so a caller polling at a coarser step than
+// the interval still averages the target rate.
+class FrameScheduler
+{
+private:
+	double frameSeconds;		// 0 draws as soon as something is pending
+	double nextFrame;			// earliest time of the next frame
+	bool pending;
+
+	long long requests;
+	long long coalesced;		// requests that found a frame already pending
+	long long frames;
+	long long idleSlots;		// frame slots skipped because nothing changed
+
+public:
+	FrameScheduler(double targetFps = 60.0);
+
+	// 0 or less: no pacing, only coalescing
+	void setTargetFps(double fps);
+	double getTargetFps() const { return frameSeconds > 0.0 ? 1.0 / frameSeconds : 0.0; }
+
+	void requestRedraw();
+	bool isPending() const { return pending; }
+	// a frame is pending and its slot has come, at time now (seconds)
+	bool frameDue(double now);
+	// a frame was drawn at time now, pending or not (window exposed, resized)
+	void frameDrawn(double now);
+
+	long long getRequests() const { return requests; }
+	long long getCoalesced() const { return coalesced; }
+	long long getFrames() const { return frames; }
+	long long getIdleSlots() const { return idleSlots; }
+	void resetStats();
+};
+
+#endif
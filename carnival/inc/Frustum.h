@@ -0,0 +1,29 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include "Vectors.h"
+#include "Matrices.h"
+
+// The six planes of a view frustum in world space, taken from projection * view.
+// Bounding volumes are tested conservatively: false only when the volume is entirely
+// outside one plane, so anything that may show up on screen is kept.
+class Frustum
+{
+private:
+	// left, right, bottom, top, near, far: inside where n.p + d >= 0
+	float planes[6][4];
+
+public:
+	Frustum();
+
+	// planes of viewProjection (projection * view), in the space the view maps from
+	void set(const Matrix4& viewProjection);
+
+	bool sphereVisible(const Vector3& center, float radius) const;
+	// axis aligned box
+	bool boxVisible(const Vector3& boxMin, const Vector3& boxMax) const;
+	// box given in model space, bounded again in world space after the model transform
+	bool boxVisible(const Vector3& boxMin, const Vector3& boxMax, const Matrix4& model) const;
+};
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef INPUT_LOG_H
+#define INPUT_LOG_H
+
+#include <cstddef>
+#include <vector>
+
+class Simulation;
+
+// Gun input of a session stamped with the simulation tick it went into, and the ducks
+// every tick hit. Replaying the inputs at the same ticks drives the Simulation exactly
+// like the live session did, so the replay has to hit the same ducks at the same ticks;
+// checkHits() says where it first did not.
+//
+// The file is little endian binary: a header, then the inputs and the hits with their
+// ticks stored as varint deltas, so a long session stays small.
+class InputLog
+{
+public:
+	enum Type { SHOOT, MOVE, MOVING };
+
+	struct Input
+	{
+		long long tick;			// applied before this tick runs
+		Type type;
+		float x;				// MOVE: gun delta, MOVING: 0 or 1
+		float y;
+	};
+
+	struct Hit
+	{
+		long long tick;
+		int duck;
+	};
+
+private:
+	double tickSeconds;
+	int lanes;
+	long long ticks;			// length of the session
+
+	std::vector<Input> inputs;
+	std::vector<Hit> hits;
+
+	// replay position
+	size_t nextInput;
+	size_t nextHit;
+	long long mismatchTick;		// first tick whose hits differ, -1 while they all match
+
+public:
+	InputLog();
+
+	// forget everything, a new session of the gallery with these settings
+	void start(double tickSeconds, int lanes);
+
+	// recording: input for the tick the simulation runs next, hits after each tick
+	void record(const Input& input);
+	void recordTick(const Simulation& simulation);
+
+	bool save(const char* fileName) const;
+	// false for a broken file, and for lanes or a tick length no gallery can run
+	bool load(const char* fileName);
+	// whether the file starts like an input log (the headless driver also reads text scripts)
+	static bool isInputLog(const char* fileName);
+
+	// replay: back to the first tick
+	void rewind();
+	// apply the inputs stamped with the tick the simulation runs next, appended to applied if given
+	void replay(Simulation& simulation, std::vector<Input>* applied = NULL);
+	// after a tick, false when its hits differ from the recorded ones
+	bool checkHits(const Simulation& simulation);
+	// every tick so far hit what was recorded, and nothing recorded is left over
+	bool hitsMatch() const { return mismatchTick < 0 && nextHit == hits.size(); }
+	long long getMismatchTick() const { return mismatchTick; }
+
+	// feed one input to the simulation, same calls the game makes
+	static void apply(Simulation& simulation, const Input& input);
+
+	double getTickSeconds() const { return tickSeconds; }
+	int getLanes() const { return lanes; }
+	long long getTicks() const { return ticks; }
+	size_t getInputCount() const { return inputs.size(); }
+	size_t getHitCount() const { return hits.size(); }
+};
+
+#endif
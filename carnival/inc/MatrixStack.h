@@ -0,0 +1,38 @@
+#ifndef MATRIX_STACK_H
+#define MATRIX_STACK_H
+
+#include <vector>
+
+#include "Vectors.h"
+#include "Matrices.h"
+
+// Replacement for the fixed-function modelview stack. The calls post-multiply the
+// top matrix like glTranslatef/glRotatef/glScalef do, so a push/transform/pop block
+// reads in the same order the old GL code did (Matrix4's own translate/rotate/scale
+// premultiply instead).
+class MatrixStack
+{
+private:
+	std::vector<Matrix4> stack;		// back() is the current matrix
+
+public:
+	MatrixStack();
+
+	void push();
+	void pop();
+
+	void loadIdentity();
+	void load(const Matrix4& m);
+	void multiply(const Matrix4& m);
+
+	void translate(float x, float y, float z);
+	void rotate(float angle, float x, float y, float z);		// degrees
+	void scale(float x, float y, float z);
+	// same matrix gluLookAt builds
+	void lookAt(const Vector3& eye, const Vector3& target, const Vector3& up);
+
+	const Matrix4& top() const { return stack.back(); }
+	int depth() const { return (int)stack.size(); }
+};
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef MESH_LOD_H
+#define MESH_LOD_H
+
+#include "Vectors.h"
+#include "Matrices.h"
+
+// Level of detail for the tessellated meshes (spheres and cylinders). Every mesh is
+// built at LEVELS tessellations, level 0 the finest, each level halving the slices and
+// stacks. A draw picks its level from the radius the object covers on screen.
+class MeshLod
+{
+public:
+	static const int LEVELS = 4;
+	// coarsest tessellation any level goes down to
+	static const int MIN_SEGMENTS = 4;
+
+	// slices/stacks of a level for a mesh whose finest level has 'finest'
+	static int segments(int finest, int level);
+
+	// radius in pixels of a sphere at eyeCenter (eye space) for a perspective projection
+	static float screenRadius(const Matrix4& projection, int viewportHeight, const Vector3& eyeCenter, float radius);
+
+	// level for an object covering screenRadius pixels
+	static int select(float screenRadius);
+
+	// largest scale factor of a model matrix, to bound a scaled radius
+	static float maxScale(const Matrix4& model);
+};
+
+#endif
@@ -0,0 +1,84 @@
+#ifndef PERF_HUD_H
+#define PERF_HUD_H
+
+#include <string>
+#include <vector>
+
+// On-screen performance overlay: fps, a frame time graph and the render/simulation
+// counters of the last frame. The GLUT 8x13 font is built into one glyph texture
+// once; every frame the whole overlay (panel, text and graph bars) is one vertex
+// buffer of quads drawn with a single glDrawArrays. The numbers are refreshed a
+// few times a second so they stay readable.
+class PerfHud
+{
+public:
+	// what the HUD shows besides frame times, filled in by the caller every frame
+	struct Stats
+	{
+		int drawCalls;
+		int triangles;
+		int stateChanges;
+		int stateChangesAvoided;
+		int culled;
+		long long ticks;		// simulation ticks since start
+		int ducks;
+		int ducksStanding;
+		int bullets;
+	};
+
+	// frame times kept for the graph (one bar each)
+	static const int GRAPH_FRAMES = 120;
+
+private:
+	struct Vertex
+	{
+		float x, y;				// pixels, origin at the top left
+		float u, v;
+		unsigned char color[4];
+	};
+
+	GLuint progId;
+	GLuint vao;
+	GLuint vbo;
+	GLuint glyphTexture;
+	GLint uniformScreenSize;
+	GLint uniformGlyphs;
+
+	bool visible;
+
+	// frame times (ms) in a ring, newest at frameTimes[(nextFrame - 1) % GRAPH_FRAMES]
+	float frameTimes[GRAPH_FRAMES];
+	int nextFrame;
+	double lastFrame;
+
+	// text refreshed every REFRESH_SECONDS
+	std::vector<std::string> lines;
+	double lastRefresh;
+	long long refreshTicks;
+	int refreshFrames;
+
+	std::vector<Vertex> vertices;
+
+	void createGlyphTexture();
+	void refresh(const Stats& stats, double now);
+	void addQuad(float x0, float y0, float x1, float y1, float u0, float v0, float u1, float v1, const unsigned char color[4]);
+	void addSolid(float x0, float y0, float x1, float y1, const unsigned char color[4]);
+	void addText(float x, float y, const std::string& text, const unsigned char color[4]);
+
+public:
+	PerfHud();
+	~PerfHud();
+
+	// compile the program and build the glyph texture, needs a current GL context
+	bool initGLSL();
+
+	void setVisible(bool visible) { this->visible = visible; }
+	bool isVisible() const { return visible; }
+
+	// once per displayCB, now in seconds (SimClock::now())
+	void frame(double now);
+	// on top of everything, call last before swapping
+	void draw(const Stats& stats, int screenWidth, int screenHeight);
+};
+
+#endif
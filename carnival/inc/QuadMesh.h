@@ -1,3 +1,5 @@
+class Renderer;
+
 struct MeshVertex
 {
 	Vector3	position;
@@ -5,14 +7,9 @@ struct MeshVertex
 };
 
 
-
-struct MeshQuad
-{
-	// pointers to vertices of each quad
-	MeshVertex *vertices[4];	
-};
-
-
+// Flat grid of quads (the ground).
+// InitMesh builds an interleaved position/normal/uv vertex array with triangle indices,
+// CreateMeshVBO uploads it and DrawMesh draws the whole grid with one glDrawElements.
 class QuadMesh
 {
 private:
@@ -21,25 +18,30 @@ private:
 	int minMeshSize;
 	float meshDim;
 
+	// size of the grid built by the last InitMesh
+	int meshSize;
+
 	int numVertices;
 	MeshVertex *vertices;
 
-	int numQuads;
-	MeshQuad *quads;
+	// box around every vertex, for frustum culling
+	Vector3 boundsMin;
+	Vector3 boundsMax;
 
+	// interleaved position (xyz) + normal (xyz) + uv, Renderer::VERTEX_FLOATS per vertex
 	std::vector<float> verticesVBO;
-	std::vector<float> normalsVBO;
 	std::vector<unsigned int> indices;
 
 	int numFacesDrawn;
+
+	GLuint vao;
+	GLuint vbos[2];
+	GLsizei indexCount;
 	
 	GLfloat mat_ambient[4];
     GLfloat mat_specular[4];
     GLfloat mat_diffuse[4];
 	GLfloat mat_shininess[1];
-
-	GLuint vao;
-	GLuint vbos[3];
 	
 private:
 	bool CreateMemory();
@@ -51,25 +53,22 @@ public:
 
 	QuadMesh(int maxMeshSize = 40, float meshDim = 1.0f);
 	
-	~QuadMesh()
-	{
-		FreeMemory();
-	}
+	~QuadMesh();
 
 	MaxMeshDim GetMaxMeshDimentions()
 	{
 		return MaxMeshDim(minMeshSize, maxMeshSize);
 	}
-	void QuadMesh::addVertex(float x, float y, float z);
-	void QuadMesh::addNormal(float nx, float ny, float nz);
-	void QuadMesh::addIndices(unsigned int i1, unsigned int i2, unsigned int i3, unsigned int i4);
-	bool InitMesh(int meshSize, Vector3 origin, double meshLength, double meshWidth,Vector3 dir1, Vector3 dir2);
-	void DrawMesh(int meshSize);
-	void DrawMeshVBO(int meshSize);
-	void QuadMesh::CreateMeshVBO(int meshSize, GLint attribVertexPosition, GLint attribVertexNormal);
+	void addVertex(float x, float y, float z, float nx, float ny, float nz, float u, float v);
+	void addIndices(unsigned int i1, unsigned int i2, unsigned int i3);
+	// textureTiles is how many times the texture repeats along each side of the mesh
+	bool InitMesh(int meshSize, Vector3 origin, double meshLength, double meshWidth, Vector3 dir1, Vector3 dir2, int textureTiles = 16);
+	// upload the mesh built by InitMesh, needs a current GL context (call again after InitMesh)
+	void CreateMeshVBO();
+	// skipped when the mesh is outside the renderer's frustum
+	void DrawMesh(Renderer& renderer);
 	void SetMaterial(Vector3 ambient, Vector3 diffuse, Vector3 specular, double shininess);
 	void ComputeNormals();
 	
 	
 };
-
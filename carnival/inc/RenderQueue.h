@@ -0,0 +1,64 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <vector>
+
+#include "Matrices.h"
+
+// Material of the lit program, same values glMaterialfv used to take
+struct Material
+{
+	float ambient[4];
+	float diffuse[4];
+	float specular[4];
+	float shininess;
+};
+
+// Draw calls of one pass, collected instead of issued. sort() orders them by
+// program, then texture, then material, so the renderer walking the sorted items only
+// changes state between runs of equal keys. GL-free: programs, textures and buffers are
+// plain handles here.
+class RenderQueue
+{
+public:
+	struct Item
+	{
+		unsigned long long key;		// program | texture | material, see makeKey()
+		unsigned int program;
+		unsigned int texture;		// 0 for untextured
+		int material;				// index into the material table
+		unsigned int vao;
+		unsigned int mode;
+		int count;
+		unsigned int indexType;
+		unsigned int indexOffset;	// bytes into the index buffer
+		Matrix4 model;
+	};
+
+private:
+	std::vector<Item> items;
+	// every distinct material seen so far, equal materials share one index
+	std::vector<Material> materials;
+
+	static unsigned long long makeKey(unsigned int program, unsigned int texture, int material);
+
+public:
+	// index of the material in the table, added on first use
+	int addMaterial(const Material& material);
+	// index of an equal material already in the table, -1 if there is none
+	int findMaterial(const Material& material) const;
+	const Material& getMaterial(int index) const { return materials[index]; }
+	int getMaterialCount() const { return (int)materials.size(); }
+
+	void submit(unsigned int program, unsigned int texture, int material,
+		unsigned int vao, unsigned int mode, int count, unsigned int indexType, unsigned int indexOffset, const Matrix4& model);
+
+	// stable, so items with the same state keep their submission order
+	void sort();
+	void clear() { items.clear(); }
+
+	const std::vector<Item>& getItems() const { return items; }
+	int size() const { return (int)items.size(); }
+};
+
+#endif
@@ -0,0 +1,170 @@
+#ifndef RENDERER_H
+#define RENDERER_H
+
+#include <string>
+#include "Matrices.h"
+#include "RenderQueue.h"
+#include "MeshLod.h"
+#include "Frustum.h"
+
+// Core profile (3.3) replacement for the fixed-function state the scene used:
+// one lit program with explicit uniforms for the matrices, light 0 and the material,
+// plus the glut solids the gun used. The sphere comes in MeshLod::LEVELS tessellations
+// and each drawSolidSphere() picks one from its radius on screen.
+//
+// Draws between begin() and end() are deferred: setTexture()/setMaterial()/setModel()
+// only record state, every draw goes into a RenderQueue with it, and end() sorts the
+// queue and issues it changing texture and material only where they differ from the
+// previous draw. Draws whose bounds fall outside the camera's frustum are dropped
+// before they reach the queue and counted as culled.
+//
+// Light 0 and the material table live in two std140 uniform buffers (Light and Materials
+// blocks) that every lit program shares: the renderer's, the duck batch's and the water's.
+// Their fragment shaders get the blocks and blinnPhong() from litFragmentSource().
+// A draw only sets materialIndex.
+//
+// Vertex layout of every mesh drawn with the lit program (attribute locations):
+//   0 position (xyz), 1 normal (xyz), 2 texture coordinate (uv)
+class Renderer
+{
+public:
+	enum Attribute { POSITION = 0, NORMAL = 1, TEXCOORD = 2 };
+
+	// floats per interleaved vertex: position, normal, uv
+	static const int VERTEX_FLOATS = 8;
+
+	// uniform buffer binding points
+	enum UniformBlock { LIGHT_BLOCK = 0, MATERIAL_BLOCK = 1 };
+	// size of the Materials block array in the shaders, addMaterial() refuses more
+	static const int MAX_MATERIALS = 64;
+
+private:
+	GLuint progId;
+
+	GLint uniformModelViewMatrix;
+	GLint uniformNormalMatrix;
+	GLint uniformProjectionMatrix;
+	GLint uniformMaterialIndex;
+	GLint uniformUseTexture;
+	GLint uniformTexture;
+
+	Matrix4 view;
+	Matrix4 projection;
+	Matrix4 model;
+	Frustum frustum;			// of view and projection, world space
+	int viewportWidth;
+	int viewportHeight;
+
+	// light 0, position in eye space (it follows the camera, as set with an identity modelview)
+	float lightPosition[4];
+	float lightAmbient[4];
+	float lightDiffuse[4];
+	float lightSpecular[4];
+	bool lightChanged;
+
+	// Light and Materials blocks
+	GLuint lightUbo;
+	GLuint materialUbo;
+	int uploadedMaterials;		// materials of the queue's table already in materialUbo
+	bool materialsFull;			// a material was refused, reported once
+
+	// glutSolidCube(1) and glutSolidSphere(1, 50, 50), the sphere's coarser levels follow
+	// the finest one in the same buffers
+	GLuint cubeVao;
+	GLuint cubeVbos[2];
+	GLsizei cubeIndexCount;
+	GLuint sphereVao;
+	GLuint sphereVbos[2];
+	GLsizei sphereIndexCount[MeshLod::LEVELS];
+	GLsizei sphereIndexOffset[MeshLod::LEVELS];
+
+	// no attributes, for shaders that make their own vertices (laser point)
+	GLuint emptyVao;
+
+	// draws of the current pass and the state they were recorded with
+	RenderQueue queue;
+	GLuint texture;
+	int material;
+
+	int drawCalls;
+	int triangles;
+	int culled;					// draws skipped because they were off screen
+	int stateChanges;			// program, texture and material changes issued
+	int stateChangesAvoided;	// the same, skipped because the previous draw had them already
+
+private:
+	void createSolids();
+	void createUniformBuffers();
+	void submit(GLuint vao, GLenum mode, GLsizei count, GLenum indexType, GLsizei indexOffset, const Matrix4& model);
+	void flush();
+
+public:
+	Renderer();
+	~Renderer();
+
+	// compile a program from vertex and fragment source, 0 (and the log) on failure.
+	// Light and Materials blocks found in it are tied to the shared binding points.
+	static GLuint createProgram(const char* vsSource, const char* fsSource, const char* name);
+	// fragment shader of a lit program: "#version", the Light and Materials blocks sized to
+	// MAX_MATERIALS, materialIndex and blinnPhong(material, eye position, eye normal), then main
+	static std::string litFragmentSource(const char* main);
+
+	// compile the lit program and build the buffers, needs a current GL context
+	bool initGLSL();
+
+	void setLight(const float position[4], const float ambient[4], const float diffuse[4], const float specular[4]);
+	// index of a material in the Materials block, for programs that draw on their own;
+	// past MAX_MATERIALS new materials are refused and get material 0
+	int addMaterial(const Material& material);
+	// send a changed light and new materials to the uniform buffers, once per frame
+	// before anything is drawn (the renderer's own passes do it too)
+	void updateUniformBuffers();
+	// set at the start of a pass, also sets the frustum
+	void setCamera(const Matrix4& view, const Matrix4& projection);
+	// size in pixels of what the projection maps to, for picking levels of detail
+	void setViewport(int width, int height);
+
+	// start collecting draws of the lit program
+	void begin();
+	// sort and issue the collected draws
+	void end();
+
+	void setMaterial(const float ambient[4], const float diffuse[4], const float specular[4], float shininess);
+	// 0 turns texturing off
+	void setTexture(GLuint texture);
+	void setModel(const Matrix4& model);
+
+	// frustum tests of world space bounds, a false result counts as a culled draw
+	bool isVisible(const Vector3& center, float radius);
+	bool isVisible(const Vector3& boxMin, const Vector3& boxMax, const Matrix4& model);
+
+	void drawSolidCube(float size);
+	void drawSolidSphere(float radius);
+	// whole index buffer of a mesh VAO laid out like the lit program expects
+	void drawIndexed(GLuint vao, GLenum mode, GLsizei count, GLenum indexType);
+	// one point at the origin of the current program's space, drawn right away (outside a pass)
+	void drawPoint();
+
+	const Matrix4& getView() const { return view; }
+	const Matrix4& getProjection() const { return projection; }
+	const Frustum& getFrustum() const { return frustum; }
+	int getViewportWidth() const { return viewportWidth; }
+	int getViewportHeight() const { return viewportHeight; }
+	const float* getLightPosition() const { return lightPosition; }
+	const float* getLightAmbient() const { return lightAmbient; }
+	const float* getLightDiffuse() const { return lightDiffuse; }
+	const float* getLightSpecular() const { return lightSpecular; }
+
+	// a draw a program of its own issued (duck batch, water, skybox), counted with the queued ones
+	void countDraw(int triangles) { drawCalls++; this->triangles += triangles; }
+
+	// counts since the last resetStats()
+	int getDrawCalls() const { return drawCalls; }
+	int getTriangles() const { return triangles; }
+	int getCulled() const { return culled; }
+	int getStateChanges() const { return stateChanges; }
+	int getStateChangesAvoided() const { return stateChangesAvoided; }
+	void resetStats() { drawCalls = triangles = culled = stateChanges = stateChangesAvoided = 0; }
+};
+
+#endif
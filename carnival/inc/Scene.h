@@ -0,0 +1,82 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include "Matrices.h"
+#include "SineWaveStrip.h"
+
+class Renderer;
+class Simulation;
+class QuadMesh;
+class CubeMesh;
+class DuckMesh;
+class DuckBatch;
+class FrameProfiler;
+
+// The carnival scene and the passes it is drawn in: ground, ducks, gun and booth,
+// water, skybox and laser. displayCB and the frame benchmark both draw a frame with
+// draw(), so the benchmark times exactly the passes the game runs. Images are loaded
+// by the caller and handed over with setTextures(); the HUD is not part of the scene.
+class Scene
+{
+public:
+	struct Textures
+	{
+		GLuint ground;
+		GLuint boothTop;
+		GLuint boothSide;
+		GLuint boothFront;
+		GLuint skybox;			// cube map
+	};
+
+private:
+	// ground grid, meshSize quads per side
+	QuadMesh* ground;
+	// booth consists of top, sides and front
+	CubeMesh* boothTop;
+	CubeMesh* boothLeftSide;
+	CubeMesh* boothRightSide;
+	CubeMesh* boothFront;
+	bool drawBoothFront;
+	// water wall, animated in its vertex shader
+	SineWaveMesh water;
+	int waveSegments;
+	// geometry shared by all ducks, drawn with instancing
+	DuckMesh* duckMesh;
+	DuckBatch* duckBatch;
+
+	Textures textures;
+
+	GLuint laserProgram;
+	GLuint skyboxProgram;
+	GLint uniformSkyboxViewProjection;
+	GLuint skyboxVao;					// unit cube facing inwards
+	GLuint skyboxVbos[2];				// positions, indices
+
+private:
+	void createSkybox();
+	void drawSkybox(Renderer& renderer, const Matrix4& view);
+
+public:
+	Scene(int meshSize, int waveSegments = SINE_WAVE_SEGMENTS);
+	~Scene();
+
+	// compile the laser and skybox programs and upload the ground, water and ducks,
+	// needs a current GL context and an initialized renderer (CubeMesh::CreateMeshVBO()
+	// is left to the caller). Without the instancing program the ducks are left out.
+	bool initGLSL(Renderer& renderer);
+	void release();
+
+	void setTextures(const Textures& textures) { this->textures = textures; }
+	void setBoothFront(bool visible) { drawBoothFront = visible; }
+
+	// one frame of every pass, ducks, bullets and water between the last two ticks (alpha).
+	// The ground and the sky use skyView, the rest view. Renderer stats are reset first,
+	// so afterwards they count the whole scene. With a profiler each pass is timed.
+	void draw(Renderer& renderer, Simulation& simulation, const Matrix4& view, const Matrix4& skyView,
+			  const Matrix4& projection, float alpha, FrameProfiler* profiler);
+
+	// ducks the last draw() skipped as off screen
+	int getDucksCulled();
+};
+
+#endif
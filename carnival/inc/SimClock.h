@@ -0,0 +1,43 @@
+#ifndef SIM_CLOCK_H
+#define SIM_CLOCK_H
+
+// Fixed timestep clock. Real time between frames goes into an accumulator and is
+// paid out in whole ticks of tickSeconds, so the simulation advances the same way
+// no matter how often or how late frames are drawn. The remainder (getAlpha) is how
+// far the frame is between the last two ticks, for interpolating what gets drawn.
+class SimClock
+{
+private:
+	double tickSeconds;
+	int maxTicksPerFrame;		// after a long stall drop time instead of catching up forever
+
+	double accumulator;
+	double lastTime;
+	bool started;
+	long long tick;				// ticks run since start
+
+public:
+	SimClock(double tickSeconds = 0.01, int maxTicksPerFrame = 10);
+
+	// seconds from a monotonic clock
+	static double now();
+
+	// add the real time since the last call, returns how many ticks to run now
+	int advance();
+	// same with the elapsed time given (headless runs, tests)
+	int advance(double elapsedSeconds);
+
+	// call once per tick that was run
+	void tickDone() { tick++; }
+
+	void reset();
+	// forget the real time since the last advance() (after a pause), keeps the ticks
+	void resync() { started = false; }
+
+	double getTickSeconds() const { return tickSeconds; }
+	long long getTick() const { return tick; }
+	// 0..1 between the previous and the current tick
+	float getAlpha() const { return (float)(accumulator / tickSeconds); }
+};
+
+#endif
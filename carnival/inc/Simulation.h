@@ -0,0 +1,64 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <vector>
+#include "Vectors.h"
+#include "Matrices.h"
+#include "DuckSystem.h"
+#include "TargetGrid.h"
+#include "Gun.h"
+
+// Everything the game simulates, without GL or GLUT: the duck gallery, the gun and its
+// bullets, and hit detection. One tick() is one fixed step (SimClock), the game and the
+// headless driver call it the same way and read the results back.
+class Simulation
+{
+private:
+	double tickSeconds;
+
+	DuckSystem ducks;
+	Gun gun;
+	TargetGrid targetGrid;
+	std::vector<int> hitCandidates;		// reused every bullet, no allocation per tick
+	std::vector<int> tickHitDucks;		// ducks hit during the last tick, in hit order
+
+	bool moving = true;
+
+	long long ticks = 0;
+	long long totalHits = 0;
+	long long shotsFired = 0;
+
+	// move bullets and flip the ducks they hit
+	void updateBullets();
+
+public:
+	// most lanes a gallery can have, six million ducks
+	static const int MAX_LANES = 1000000;
+
+	Simulation(double tickSeconds = 0.01, int maxBullets = 64);
+
+	// gallery of lanes, each lane is one loop of six ducks (three on top, three flipped below).
+	// lanes is clamped to 1..MAX_LANES
+	void setupGallery(int lanes, float laneSpacing = 4.0f);
+
+	// one fixed step of the whole simulation
+	void tick();
+
+	// input
+	bool shoot();
+	void moveGun(float x, float y) { gun.moveGun(x, y); }
+	void setMoving(bool moving) { this->moving = moving; }
+	bool isMoving() const { return moving; }
+
+	DuckSystem& getDucks() { return ducks; }
+	Gun& getGun() { return gun; }
+
+	double getTickSeconds() const { return tickSeconds; }
+	long long getTicks() const { return ticks; }
+	int getTickHits() const { return (int)tickHitDucks.size(); }
+	const std::vector<int>& getTickHitDucks() const { return tickHitDucks; }
+	long long getTotalHits() const { return totalHits; }
+	long long getShotsFired() const { return shotsFired; }
+};
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef TARGET_GRID_H
+#define TARGET_GRID_H
+
+#include <vector>
+#include "Vectors.h"
+
+class DuckSystem;
+
+// Uniform grid broadphase over the bullseyes of a DuckSystem in the x/z plane
+// (the ducks slide along x and the lanes are spread along z, bullets travel down z).
+// build() bins every duck once per tick with a counting sort into flat arrays, query()
+// returns the ducks in the cells a bullet step can touch, which are then checked with
+// DuckSystem::hit. Storage grows to the largest gallery seen and is reused after that.
+class TargetGrid
+{
+private:
+	float cellSize;
+
+	// grid placement from the last build(), cells may be coarser than cellSize for a wide gallery
+	float gridCellSize;
+	float originX;
+	float originZ;
+	int cellsX;
+	int cellsZ;
+
+	// ducks of cell c are cellDucks[cellStart[c] .. cellStart[c + 1])
+	std::vector<int> cellStart;
+	std::vector<int> cellDucks;
+	std::vector<int> duckCell;
+
+	int cellX(float x) const;
+	int cellZ(float z) const;
+
+public:
+	TargetGrid(float cellSize = 2.0f);
+
+	// rebin all bullseyes, call after DuckSystem::updateTargetCoords
+	void build(const DuckSystem& ducks);
+
+	// ducks whose hit volume may overlap the segment from -> to, appended to candidates
+	int query(Vector3 from, Vector3 to, float radius, float depth, std::vector<int>& candidates) const;
+
+	int getCellsX() const { return cellsX; }
+	int getCellsZ() const { return cellsZ; }
+};
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef TIMING_HISTORY_H
+#define TIMING_HISTORY_H
+
+#include <vector>
+
+// The last CAPACITY timings (milliseconds) of something measured once per frame,
+// summarized as min/avg/p99 on demand.
+class TimingHistory
+{
+public:
+	static const int CAPACITY = 256;
+
+	struct Summary
+	{
+		float min;
+		float avg;
+		float p99;
+		int samples;
+	};
+
+private:
+	float samples[CAPACITY];
+	int next;			// slot the next sample goes into
+	int count;
+
+public:
+	TimingHistory();
+
+	void add(float milliseconds);
+	void clear();
+	int size() const { return count; }
+
+	// all zero without samples
+	Summary summarize() const;
+};
+
+#endif
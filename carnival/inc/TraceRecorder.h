@@ -0,0 +1,79 @@
+#ifndef TRACE_RECORDER_H
+#define TRACE_RECORDER_H
+
+#include <atomic>
+
+// Timeline of what the game did, for the Chrome trace viewer (chrome://tracing, Perfetto).
+// Events go into a fixed ring buffer; any thread can record without a lock (a slot is
+// claimed with one atomic increment) and the oldest events are overwritten when it is
+// full. write() saves what the ring holds as Chrome trace JSON.
+//
+// Names, categories and details are kept as pointers: pass string literals or
+// anything else that lives as long as the recorder.
+class TraceRecorder
+{
+public:
+	struct Event
+	{
+		const char* name;
+		const char* category;
+		const char* detail;		// shown as args.detail, may be NULL
+		double start;			// seconds, SimClock::now()
+		double duration;		// seconds, complete events only
+		int thread;
+		char phase;				// 'X' complete, 'i' instant
+	};
+
+private:
+	struct Slot
+	{
+		Event event;
+		// index + 1 of the event in it once written, 0 while being written
+		std::atomic<unsigned long long> sequence;
+	};
+
+	Slot* slots;
+	unsigned long long mask;				// capacity - 1, capacity is a power of two
+	std::atomic<unsigned long long> next;	// events recorded so far
+	double origin;							// trace time 0
+
+	void record(const Event& event);
+	static int threadIndex();
+
+public:
+	// capacity is rounded up to a power of two
+	TraceRecorder(int capacity = 65536);
+	~TraceRecorder();
+
+	// something that took from start to end (seconds, SimClock::now())
+	void complete(const char* name, const char* category, double start, double end, const char* detail = NULL);
+	// something that happened now
+	void instant(const char* name, const char* category, const char* detail = NULL);
+
+	// events still in the ring, oldest first, as a Chrome trace JSON file
+	bool write(const char* fileName) const;
+
+	unsigned long long getRecorded() const { return next.load(std::memory_order_relaxed); }
+	int getCapacity() const { return (int)(mask + 1); }
+
+private:
+	TraceRecorder(const TraceRecorder&);
+	TraceRecorder& operator=(const TraceRecorder&);
+};
+
+// records a complete event for the block it lives in
+class TraceScope
+{
+private:
+	TraceRecorder& recorder;
+	const char* name;
+	const char* category;
+	const char* detail;
+	double start;
+
+public:
+	TraceScope(TraceRecorder& recorder, const char* name, const char* category, const char* detail = NULL);
+	~TraceScope();
+};
+
+#endif
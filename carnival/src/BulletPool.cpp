@@ -0,0 +1,71 @@
+#include <vector>
+
+#include "BulletPool.h"
+
+BulletPool::BulletPool(int capacity)
+{
+	// everything is sized once here, nothing grows afterwards
+	this->capacity = capacity;
+	originX.resize(capacity);
+	originY.resize(capacity);
+	angle.resize(capacity);
+	trajectory.resize(capacity);
+	lastTrajectory.resize(capacity);
+	freeSlots.resize(capacity);
+	liveSlots.resize(capacity);
+	livePosition.resize(capacity);
+	clear();
+}
+
+void BulletPool::clear()
+{
+	// lowest slots are handed out first
+	for (int i = 0; i < capacity; i++)
+		freeSlots[i] = capacity - 1 - i;
+	freeCount = capacity;
+	liveCount = 0;
+}
+
+int BulletPool::fire(float x, float y, float angle)
+{
+	if (freeCount == 0)
+		return -1;
+
+	int slot = freeSlots[--freeCount];
+	originX[slot] = x;
+	originY[slot] = y;
+	this->angle[slot] = angle;
+	trajectory[slot] = 0.0f;
+	lastTrajectory[slot] = 0.0f;
+
+	livePosition[slot] = liveCount;
+	liveSlots[liveCount++] = slot;
+	return slot;
+}
+
+void BulletPool::release(int slot)
+{
+	// move the last live bullet into the hole
+	int position = livePosition[slot];
+	int last = liveSlots[--liveCount];
+	liveSlots[position] = last;
+	livePosition[last] = position;
+
+	freeSlots[freeCount++] = slot;
+}
+
+void BulletPool::step(float distance, float maxDistance)
+{
+	// walk backwards so a released bullet's replacement has already been stepped
+	for (int i = liveCount - 1; i >= 0; i--)
+	{
+		int slot = liveSlots[i];
+		if (trajectory[slot] > maxDistance)
+		{
+			release(slot);
+			continue;
+		}
+		lastTrajectory[slot] = trajectory[slot];
+		trajectory[slot] += distance;
+	}
+}
@@ -20,8 +20,15 @@
 #include <glm/gtx/quaternion.hpp>
 
 #include "Vectors.h"
+#include "Matrices.h"
+#include "Renderer.h"
 #include "CubeMesh.h"
 
+#define BUFFER_OFFSET(offset) ((void*)(offset))
+
+GLuint CubeMesh::vao = 0;
+GLuint CubeMesh::vbos[2] = { 0, 0 };
+
 static GLubyte iquads[][4] = { {0, 3, 2, 1},	// back face
 						  {2, 3, 7, 6},	// top face
 						  {0, 4, 7, 3},  // left face
@@ -47,12 +54,6 @@ static GLfloat iquadNormals[][3] = { { 0.0, 0.0, -1.0},	// Back Face
 
 CubeMesh::CubeMesh()
 {
-	// Vertex positions of a standard size cube (width 2), centered at the origin
-	// of its own Model Coordinate System
-	vertices = ivertices;
-	quads = iquads;
-	quadNormals = iquadNormals;
-
 	mat_ambient[0] = 0.05;
 	mat_ambient[1] = 0.0;
 	mat_ambient[2] = 0.0;
@@ -86,78 +87,84 @@ void CubeMesh::setMaterial(Vector3 ambient, Vector3 diffuse, Vector3 specular, d
 
 }
 
-void CubeMesh::drawCubeMesh()
+// texture coordinates of each face corner, in the order of iquads
+static GLfloat iquadTexCoords[][4][2] = { { {0, 1}, {1, 1}, {1, 0}, {0, 0} },	// back face
+									{ {0, 1}, {1, 1}, {1, 0}, {0, 0} },	// top face
+									{ {0, 0}, {1, 0}, {1, 1}, {0, 1} },	// left face
+									{ {1, 0}, {1, 1}, {0, 1}, {0, 0} },	// right face
+									{ {0, 0}, {1, 0}, {1, 1}, {0, 1} },	// front face
+									{ {0, 1}, {1, 1}, {1, 0}, {0, 0} } };	// bottom face
+
+///////////////////////////////////////////////////////////////////////////////
+// 24 vertices (four per face so each face keeps its normal and uvs), position +
+// normal + uv interleaved, and 36 indices splitting each quad into two triangles
+///////////////////////////////////////////////////////////////////////////////
+void CubeMesh::CreateMeshVBO()
+{
+	if (vao) return;
+
+	GLfloat vertexData[6 * 4 * Renderer::VERTEX_FLOATS];
+	GLubyte indices[6 * 6];
+	GLfloat* v = vertexData;
+	for (int face = 0; face < 6; face++)
+	{
+		for (int corner = 0; corner < 4; corner++)
+		{
+			const GLfloat* position = ivertices[iquads[face][corner]];
+			v[0] = position[0];
+			v[1] = position[1];
+			v[2] = position[2];
+			v[3] = iquadNormals[face][0];
+			v[4] = iquadNormals[face][1];
+			v[5] = iquadNormals[face][2];
+			v[6] = iquadTexCoords[face][corner][0];
+			v[7] = iquadTexCoords[face][corner][1];
+			v += Renderer::VERTEX_FLOATS;
+		}
+		// quad 0 1 2 3 as triangles 0 1 2, 2 3 0
+		GLubyte base = face * 4;
+		GLubyte quad[6] = { base, (GLubyte)(base + 1), (GLubyte)(base + 2), (GLubyte)(base + 2), (GLubyte)(base + 3), base };
+		for (int i = 0; i < 6; i++)
+			indices[face * 6 + i] = quad[i];
+	}
+
+	const int stride = Renderer::VERTEX_FLOATS * sizeof(GLfloat);
+	glGenVertexArrays(1, &vao);
+	glBindVertexArray(vao);
+	glGenBuffers(2, vbos);
+	glBindBuffer(GL_ARRAY_BUFFER, vbos[0]);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(vertexData), vertexData, GL_STATIC_DRAW);
+	glVertexAttribPointer(Renderer::POSITION, 3, GL_FLOAT, GL_FALSE, stride, BUFFER_OFFSET(0));
+	glEnableVertexAttribArray(Renderer::POSITION);
+	glVertexAttribPointer(Renderer::NORMAL, 3, GL_FLOAT, GL_FALSE, stride, BUFFER_OFFSET(3 * sizeof(GLfloat)));
+	glEnableVertexAttribArray(Renderer::NORMAL);
+	glVertexAttribPointer(Renderer::TEXCOORD, 2, GL_FLOAT, GL_FALSE, stride, BUFFER_OFFSET(6 * sizeof(GLfloat)));
+	glEnableVertexAttribArray(Renderer::TEXCOORD);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vbos[1]);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+void CubeMesh::DeleteMeshVBO()
+{
+	if (!vao) return;
+	glDeleteBuffers(2, vbos);
+	glDeleteVertexArrays(1, &vao);
+	vao = 0;
+	vbos[0] = vbos[1] = 0;
+}
+
+void CubeMesh::drawCubeMesh(Renderer& renderer, const Matrix4& model)
 {
-	// Setup the material and lights used for the cube
-	// you may want to use the alternate material if this cube is selected
-	glMaterialfv(GL_FRONT, GL_AMBIENT, mat_ambient);
-	glMaterialfv(GL_FRONT, GL_SPECULAR, mat_specular);
-	glMaterialfv(GL_FRONT, GL_DIFFUSE, mat_diffuse);
-	glMaterialfv(GL_FRONT, GL_SHININESS, mat_shininess);
-	
-	// Draw Cube using simple immediate mode rendering
-	glBegin(GL_QUADS);
-	// Back Face
-	glNormal3f(quadNormals[0][0], quadNormals[0][1], quadNormals[0][2]);
-	glTexCoord2f(0.0f, 1.0f);
-	glVertex3f(vertices[quads[0][0]][0], vertices[quads[0][0]][1], vertices[quads[0][0]][2]);
-	glTexCoord2f(1.0f, 1.0f);
-	glVertex3f(vertices[quads[0][1]][0], vertices[quads[0][1]][1], vertices[quads[0][1]][2]);
-	glTexCoord2f(1.0f, 0.0f);
-	glVertex3f(vertices[quads[0][2]][0], vertices[quads[0][2]][1], vertices[quads[0][2]][2]);
-	glTexCoord2f(0.0f, 0.0f);
-	glVertex3f(vertices[quads[0][3]][0], vertices[quads[0][3]][1], vertices[quads[0][3]][2]);
-	// Top Face
-	glNormal3f(quadNormals[1][0], quadNormals[1][1], quadNormals[1][2]);
-	glTexCoord2f(0.0f, 1.0f);
-	glVertex3f(vertices[quads[1][0]][0], vertices[quads[1][0]][1], vertices[quads[1][0]][2]);
-	glTexCoord2f(1.0f, 1.0f);
-	glVertex3f(vertices[quads[1][1]][0], vertices[quads[1][1]][1], vertices[quads[1][1]][2]);
-	glTexCoord2f(1.0f, 0.0f);
-	glVertex3f(vertices[quads[1][2]][0], vertices[quads[1][2]][1], vertices[quads[1][2]][2]);
-	glTexCoord2f(0.0f, 0.0f);
-	glVertex3f(vertices[quads[1][3]][0], vertices[quads[1][3]][1], vertices[quads[1][3]][2]);
-
-	// Left Face
-	glNormal3f(quadNormals[2][0], quadNormals[2][1], quadNormals[2][2]);
-	glTexCoord2f(0.0f, 0.0f);
-	glVertex3f(vertices[quads[2][0]][0], vertices[quads[2][0]][1], vertices[quads[2][0]][2]);
-	glTexCoord2f(1.0f, 0.0f);
-	glVertex3f(vertices[quads[2][1]][0], vertices[quads[2][1]][1], vertices[quads[2][1]][2]);
-	glTexCoord2f(1.0f, 1.0f);
-	glVertex3f(vertices[quads[2][2]][0], vertices[quads[2][2]][1], vertices[quads[2][2]][2]);
-	glTexCoord2f(0.0f, 1.0f);
-	glVertex3f(vertices[quads[2][3]][0], vertices[quads[2][3]][1], vertices[quads[2][3]][2]);
-	// Right Face
-	glNormal3f(quadNormals[3][0], quadNormals[3][1], quadNormals[3][2]);
-	glTexCoord2f(1.0f, 0.0f);
-	glVertex3f(vertices[quads[3][0]][0], vertices[quads[3][0]][1], vertices[quads[3][0]][2]);
-	glTexCoord2f(1.0f, 1.0f);
-	glVertex3f(vertices[quads[3][1]][0], vertices[quads[3][1]][1], vertices[quads[3][1]][2]);
-	glTexCoord2f(0.0f, 1.0f);
-	glVertex3f(vertices[quads[3][2]][0], vertices[quads[3][2]][1], vertices[quads[3][2]][2]);
-	glTexCoord2f(0.0f, 0.0f);
-	glVertex3f(vertices[quads[3][3]][0], vertices[quads[3][3]][1], vertices[quads[3][3]][2]);
-	// Front Face
-	glNormal3f(quadNormals[4][0], quadNormals[4][1], quadNormals[4][2]);
-	glTexCoord2f(0.0f, 0.0f);
-	glVertex3f(vertices[quads[4][0]][0], vertices[quads[4][0]][1], vertices[quads[4][0]][2]);
-	glTexCoord2f(1.0f, 0.0f);
-	glVertex3f(vertices[quads[4][1]][0], vertices[quads[4][1]][1], vertices[quads[4][1]][2]);
-	glTexCoord2f(1.0f, 1.0f);
-	glVertex3f(vertices[quads[4][2]][0], vertices[quads[4][2]][1], vertices[quads[4][2]][2]);
-	glTexCoord2f(0.0f, 1.0f);
-	glVertex3f(vertices[quads[4][3]][0], vertices[quads[4][3]][1], vertices[quads[4][3]][2]);
-	// Bottom Face
-	glNormal3f(quadNormals[5][0], quadNormals[5][1], quadNormals[5][2]);
-	glTexCoord2f(0.0f, 1.0f);
-	glVertex3f(vertices[quads[5][0]][0], vertices[quads[5][0]][1], vertices[quads[5][0]][2]);
-	glTexCoord2f(1.0f, 1.0f);
-	glVertex3f(vertices[quads[5][1]][0], vertices[quads[5][1]][1], vertices[quads[5][1]][2]);
-	glTexCoord2f(1.0f, 0.0f);
-	glVertex3f(vertices[quads[5][2]][0], vertices[quads[5][2]][1], vertices[quads[5][2]][2]);
-	glTexCoord2f(0.0f, 0.0f);
-	glVertex3f(vertices[quads[5][3]][0], vertices[quads[5][3]][1], vertices[quads[5][3]][2]);
-	glEnd();
+	// the unit cube spans -1..1, the model matrix places this instance
+	if (!renderer.isVisible(Vector3(-1.0f, -1.0f, -1.0f), Vector3(1.0f, 1.0f, 1.0f), model))
+		return;
 
+	// Setup the material used for the cube
+	renderer.setMaterial(mat_ambient, mat_diffuse, mat_specular, mat_shininess[0]);
+	renderer.setModel(model);
+	renderer.drawIndexed(vao, GL_TRIANGLES, 36, GL_UNSIGNED_BYTE);
 }
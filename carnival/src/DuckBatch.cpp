@@ -0,0 +1,378 @@
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <ctime>
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+#ifdef _WIN32
+#include <GL/wglew.h> // For wglSwapInterval
+#endif
+
+#define FREEGLUT_STATIC
+#include <GL/freeglut.h>
+
+#include "Vectors.h"
+#include "Matrices.h"
+#include "DuckMesh.h"
+#include "DuckSystem.h"
+#include "Renderer.h"
+#include "DuckBatch.h"
+
+#define BUFFER_OFFSET(offset) ((void*)(offset))
+
+// vertex attribute locations used by the instanced shader
+#define POSITION_ATTRIBUTE 0
+#define NORMAL_ATTRIBUTE 1
+#define INSTANCE_X_ATTRIBUTE 2
+#define INSTANCE_Y_ATTRIBUTE 3
+#define INSTANCE_Z_ATTRIBUTE 4
+#define INSTANCE_SPIN_ATTRIBUTE 5
+#define INSTANCE_FLIP_ATTRIBUTE 6
+
+// DuckSystem arrays copied into the instance buffer (x, y, z, spin, flipAngle)
+static const int INSTANCE_STREAMS = 5;
+
+// proportions of the duck, same as DuckTarget
+static const float targetWidth = 4.0f;
+static const float targetLength = 3.0f;
+static const float targetDepth = 1.0f;
+
+// size of a duck around its position, for picking the level of detail
+static const float DUCK_RADIUS = 3.0f;
+// level given to ducks outside the frustum, they get no slot in the buffer
+static const int CULLED = MeshLod::LEVELS;
+
+// Vertex shader: rebuilds DuckSystem::modelMatrix()'s transform chain per instance
+const char* vsDuckBatchSource = R"(
+#version 330 core
+
+layout(location = 0) in vec3 vertexPosition;
+layout(location = 1) in vec3 vertexNormal;
+layout(location = 2) in float instanceX;          // DuckSystem arrays, one value per duck
+layout(location = 3) in float instanceY;
+layout(location = 4) in float instanceZ;
+layout(location = 5) in float instanceSpin;
+layout(location = 6) in float instanceFlip;
+
+uniform mat4 partMatrix;                           // part relative to the duck
+uniform mat4 viewMatrix;
+uniform mat4 projectionMatrix;
+
+out vec3 normal;
+out vec3 position;
+flat out vec3 bullsEyeCenter;
+
+mat4 translate(vec3 t)
+{
+    return mat4(1.0, 0.0, 0.0, 0.0,
+                0.0, 1.0, 0.0, 0.0,
+                0.0, 0.0, 1.0, 0.0,
+                t.x, t.y, t.z, 1.0);
+}
+
+mat4 rotateX(float degrees)
+{
+    float c = cos(radians(degrees));
+    float s = sin(radians(degrees));
+    return mat4(1.0, 0.0, 0.0, 0.0,
+                0.0,   c,   s, 0.0,
+                0.0,  -s,   c, 0.0,
+                0.0, 0.0, 0.0, 1.0);
+}
+
+mat4 rotateZ(float degrees)
+{
+    float c = cos(radians(degrees));
+    float s = sin(radians(degrees));
+    return mat4(  c,   s, 0.0, 0.0,
+                 -s,   c, 0.0, 0.0,
+                0.0, 0.0, 1.0, 0.0,
+                0.0, 0.0, 0.0, 1.0);
+}
+
+void main(void)
+{
+    // rotateY(180) * scale(0.5)
+    mat4 base = mat4(-0.5, 0.0,  0.0, 0.0,
+                      0.0, 0.5,  0.0, 0.0,
+                      0.0, 0.0, -0.5, 0.0,
+                      0.0, 0.0,  0.0, 1.0);
+
+    mat4 model = translate(vec3(instanceX, instanceY, instanceZ)) * translate(vec3(0.0, -2.5, 0.0)) *
+                 rotateZ(instanceSpin) * translate(vec3(0.0, 2.5, 0.0)) *
+                 rotateX(instanceFlip) * base;
+
+    mat4 modelView = viewMatrix * model * partMatrix;
+    vec4 eyePosition = modelView * vec4(vertexPosition, 1.0);
+
+    gl_Position = projectionMatrix * eyePosition;
+    position = eyePosition.xyz;
+    normal = normalize(transpose(inverse(mat3(modelView))) * vertexNormal);
+    bullsEyeCenter = vec3(modelView * vec4(0.0, 0.0, 0.0, 1.0));
+}
+)";
+
+// Fragment shader: same light 0 and material as the Renderer's lit program, plus the bullseye rings
+// (Renderer::litFragmentSource() puts the lighting in front)
+const char* fsDuckBatchSource = R"(
+in vec3 normal;
+in vec3 position;
+flat in vec3 bullsEyeCenter;
+
+uniform int bullseye;                              // 1 while drawing the bullseye part
+
+out vec4 fragColor;
+
+void main()
+{
+    MaterialData material = materials[materialIndex];
+    vec3 color = blinnPhong(material, position, normal);
+
+    if (bullseye != 0)
+    {
+        // same rings as the bullseye shader
+        float ringRadius = length(position - bullsEyeCenter);
+        if (ringRadius < 0.4 || ringRadius >= 0.7)
+        {
+            fragColor = vec4(1.0, 0.0, 0.0, 1.0);
+            return;
+        }
+    }
+    fragColor = vec4(color, material.diffuse.a);
+}
+)";
+
+DuckBatch::DuckBatch(DuckMesh* mesh)
+{
+	this->mesh = mesh;
+	progId = 0;
+	vao = 0;
+	instanceVBO = 0;
+	instanceCapacity = 0;
+	uniformPartMatrix = -1;
+	uniformBullseye = -1;
+	uniformViewMatrix = uniformProjectionMatrix = -1;
+	uniformMaterialIndex = -1;
+	bodyMaterial = beakMaterial = 0;
+	culled = 0;
+	for (int level = 0; level < MeshLod::LEVELS; level++)
+		levelInstances[level] = 0;
+
+	// part transforms inside the duck; Matrix4 premultiplies, so each chain is written back to front
+	bodyMatrix.scale(targetWidth, targetLength, targetDepth);
+
+	bullseyeMatrix.scale(0.08f * targetWidth, 0.5f * targetWidth, 0.5f * targetWidth);
+	bullseyeMatrix.rotateY(-90.0f);
+	bullseyeMatrix.translate(0.0f, 0.0f, -1.05f * targetDepth);
+
+	neckMatrix.scale(0.2f * targetWidth, 0.45f * targetWidth, 1.95f * targetDepth);
+	neckMatrix.rotateY(90.0f);
+	neckMatrix.rotateZ(65.0f);
+	neckMatrix.translate(-0.55f * targetWidth, 0.3f * targetLength, 0.05f * targetDepth);
+
+	headMatrix.scale(1.05f * 0.5f * targetWidth, 1.05f * 0.5f * targetWidth, targetDepth);
+	headMatrix.translate(-0.3f * targetWidth, 1.5f * targetLength, 0.05f * targetDepth);
+
+	beakMatrix.scale(0.3f * targetWidth, 0.5f * targetWidth, 1.25f * targetDepth);
+	beakMatrix.rotateY(-90.0f);
+	beakMatrix.rotateZ(-10.0f);
+	beakMatrix.translate(-0.1f * targetWidth, -0.1f * targetLength, 0.0f);
+	beakMatrix.translate(-0.3f * targetWidth, 1.5f * targetLength, 0.05f * targetDepth);
+
+	tailMatrix.scale(0.3f * targetWidth, 0.5f * targetWidth, 1.25f * targetDepth);
+	tailMatrix.rotateY(90.0f);
+	tailMatrix.rotateZ(45.0f);
+	tailMatrix.translate(0.7f * targetWidth, 0.3f * targetLength, 0.0f);
+}
+
+DuckBatch::~DuckBatch()
+{
+	if (vao)
+	{
+		glDeleteBuffers(1, &instanceVBO);
+		glDeleteVertexArrays(1, &vao);
+	}
+	if (progId)
+		glDeleteProgram(progId);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// compile the instanced program and set up the VAO (mesh buffers + instance buffer)
+///////////////////////////////////////////////////////////////////////////////
+bool DuckBatch::initGLSL(Renderer& renderer)
+{
+	progId = Renderer::createProgram(vsDuckBatchSource, Renderer::litFragmentSource(fsDuckBatchSource).c_str(), "Duck Batch");
+	if (progId == 0)
+		return false;
+
+	uniformPartMatrix = glGetUniformLocation(progId, "partMatrix");
+	uniformBullseye = glGetUniformLocation(progId, "bullseye");
+	uniformViewMatrix = glGetUniformLocation(progId, "viewMatrix");
+	uniformProjectionMatrix = glGetUniformLocation(progId, "projectionMatrix");
+	uniformMaterialIndex = glGetUniformLocation(progId, "materialIndex");
+
+	bodyMaterial = addMaterial(renderer, mat_ambient, mat_diffuse, mat_specular, mat_shininess);
+	beakMaterial = addMaterial(renderer, beakmat_ambient, beakmat_diffuse, beakmat_specular, beakmat_shininess);
+
+	glGenVertexArrays(1, &vao);
+	glBindVertexArray(vao);
+	mesh->setupAttributes(POSITION_ATTRIBUTE, NORMAL_ATTRIBUTE);
+
+	// per-instance attributes advance once per duck, pointers are set per level by draw()
+	glGenBuffers(1, &instanceVBO);
+	for (int i = 0; i < INSTANCE_STREAMS; i++)
+	{
+		glEnableVertexAttribArray(INSTANCE_X_ATTRIBUTE + i);
+		glVertexAttribDivisor(INSTANCE_X_ATTRIBUTE + i, 1);
+	}
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// instance buffer holds each DuckSystem array back to back, sized for
+// instanceCapacity ducks.
+///////////////////////////////////////////////////////////////////////////////
+void DuckBatch::reserveInstances(int count)
+{
+	if (count <= instanceCapacity) return;
+
+	int capacity = instanceCapacity > 0 ? instanceCapacity : 64;
+	while (capacity < count)
+		capacity *= 2;
+	instanceCapacity = capacity;
+
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+	glBufferData(GL_ARRAY_BUFFER, INSTANCE_STREAMS * instanceCapacity * sizeof(float), NULL, GL_STREAM_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// pick every duck's level from its size on screen and copy the instance streams
+// into instanceData with the ducks of each level together (counting sort).
+// Ducks outside the frustum are dropped, returns how many are left
+///////////////////////////////////////////////////////////////////////////////
+int DuckBatch::sortByLevel(const DuckSystem& ducks, const Renderer& renderer)
+{
+	int count = ducks.size();
+	const float* streams[INSTANCE_STREAMS] = { ducks.getDrawX(), ducks.getDrawY(), ducks.getDuckZ(), ducks.getDrawSpin(), ducks.getDrawFlipAngle() };
+	const Matrix4& view = renderer.getView();
+	const Frustum& frustum = renderer.getFrustum();
+	int viewportHeight = renderer.getViewportHeight();
+
+	duckLevels.resize(count);
+	culled = 0;
+	for (int level = 0; level < MeshLod::LEVELS; level++)
+		levelInstances[level] = 0;
+	for (int i = 0; i < count; i++)
+	{
+		if (!frustum.sphereVisible(DuckSystem::boundsCenter(streams[0][i], streams[1][i], streams[2][i]), DuckSystem::getBoundsRadius()))
+		{
+			duckLevels[i] = (unsigned char)CULLED;
+			culled++;
+			continue;
+		}
+
+		int level = 0;
+		if (viewportHeight > 0)
+		{
+			Vector3 eyeCenter = view * Vector3(streams[0][i], streams[1][i], streams[2][i]);
+			level = MeshLod::select(MeshLod::screenRadius(renderer.getProjection(), viewportHeight, eyeCenter, DUCK_RADIUS));
+		}
+		duckLevels[i] = (unsigned char)level;
+		levelInstances[level]++;
+	}
+
+	int next[MeshLod::LEVELS];
+	next[0] = 0;
+	for (int level = 1; level < MeshLod::LEVELS; level++)
+		next[level] = next[level - 1] + levelInstances[level - 1];
+
+	int visible = count - culled;
+	instanceData.resize(INSTANCE_STREAMS * visible);
+	for (int i = 0; i < count; i++)
+	{
+		if (duckLevels[i] == CULLED) continue;
+		int slot = next[duckLevels[i]]++;
+		for (int s = 0; s < INSTANCE_STREAMS; s++)
+			instanceData[s * visible + slot] = streams[s][i];
+	}
+	return visible;
+}
+
+int DuckBatch::addMaterial(Renderer& renderer, float* ambient, float* diffuse, float* specular, float* shininess)
+{
+	Material material;
+	for (int i = 0; i < 4; i++)
+	{
+		material.ambient[i] = ambient[i];
+		material.diffuse[i] = diffuse[i];
+		material.specular[i] = specular[i];
+	}
+	material.shininess = shininess[0];
+	return renderer.addMaterial(material);
+}
+
+void DuckBatch::drawPart(Renderer& renderer, int shape, int level, const Matrix4& partMatrix, bool bullseye, GLsizei instances)
+{
+	glUniformMatrix4fv(uniformPartMatrix, 1, GL_FALSE, partMatrix.get());
+	glUniform1i(uniformBullseye, bullseye ? 1 : 0);
+	mesh->drawPartInstanced((DuckMesh::Part)shape, level, instances);
+	renderer.countDraw(mesh->getPartCount((DuckMesh::Part)shape, level) / 3 * instances);
+}
+
+void DuckBatch::draw(const DuckSystem& ducks, Renderer& renderer)
+{
+	culled = 0;
+	GLsizei count = ducks.size();
+	if (count == 0 || vao == 0) return;
+
+	reserveInstances(count);
+	count = sortByLevel(ducks, renderer);
+	if (count == 0) return;
+
+	// orphan the old storage so the driver does not wait on last frame's draws,
+	// then copy the level-sorted SoA arrays in (no interleaving on the CPU)
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+	glBufferData(GL_ARRAY_BUFFER, INSTANCE_STREAMS * instanceCapacity * sizeof(float), NULL, GL_STREAM_DRAW);
+	for (int i = 0; i < INSTANCE_STREAMS; i++)
+		glBufferSubData(GL_ARRAY_BUFFER, i * instanceCapacity * sizeof(float), count * sizeof(float), &instanceData[i * count]);
+
+	glUseProgram(progId);
+	glBindVertexArray(vao);
+
+	// camera of this pass
+	glUniformMatrix4fv(uniformViewMatrix, 1, GL_FALSE, renderer.getView().get());
+	glUniformMatrix4fv(uniformProjectionMatrix, 1, GL_FALSE, renderer.getProjection().get());
+
+	int first = 0;
+	for (int level = 0; level < MeshLod::LEVELS; level++)
+	{
+		GLsizei instances = levelInstances[level];
+		if (instances == 0) continue;
+
+		// instance attributes start at this level's first duck
+		for (int i = 0; i < INSTANCE_STREAMS; i++)
+			glVertexAttribPointer(INSTANCE_X_ATTRIBUTE + i, 1, GL_FLOAT, GL_FALSE, 0, BUFFER_OFFSET((i * instanceCapacity + first) * sizeof(float)));
+		first += instances;
+
+		glUniform1i(uniformMaterialIndex, bodyMaterial);
+		drawPart(renderer, DuckMesh::SPHERE, level, bodyMatrix, false, instances);
+		drawPart(renderer, DuckMesh::SPHERE, level, bullseyeMatrix, true, instances);
+		drawPart(renderer, DuckMesh::NECK, level, neckMatrix, false, instances);
+		drawPart(renderer, DuckMesh::SPHERE, level, headMatrix, false, instances);
+		drawPart(renderer, DuckMesh::TAIL, level, tailMatrix, false, instances);
+
+		glUniform1i(uniformMaterialIndex, beakMaterial);
+		drawPart(renderer, DuckMesh::BEAK, level, beakMatrix, false, instances);
+	}
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glUseProgram(0);
+}
@@ -0,0 +1,173 @@
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <ctime>
+#include <cmath>
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+#ifdef _WIN32
+#include <GL/wglew.h> // For wglSwapInterval
+#endif
+
+#define FREEGLUT_STATIC
+#include <GL/freeglut.h>
+
+#include "DuckMesh.h"
+
+#define BUFFER_OFFSET(offset) ((void*)(offset))
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// position (3) + normal (3)
+static const int VERTEX_STRIDE = 6 * sizeof(float);
+
+DuckMesh::DuckMesh(int slices, int stacks)
+{
+	this->slices = slices;
+	this->stacks = stacks;
+	vbos[0] = vbos[1] = 0;
+
+	// same shapes the old gluQuadric calls produced, level 0 has their tessellation
+	for (int level = 0; level < MeshLod::LEVELS; level++)
+	{
+		addSphere(SPHERE, level, 1.0f);
+		addCylinder(NECK, level, 0.8f, 0.8f, 2.0f);
+		addCylinder(BEAK, level, 0.8f, 0.1f, 2.0f);
+		addCylinder(TAIL, level, 0.8f, 0.2f, 2.0f);
+	}
+}
+
+DuckMesh::~DuckMesh()
+{
+	if (vbos[0])
+		glDeleteBuffers(2, vbos);
+}
+
+void DuckMesh::addVertex(float x, float y, float z, float nx, float ny, float nz)
+{
+	verticesVBO.push_back(x);
+	verticesVBO.push_back(y);
+	verticesVBO.push_back(z);
+	verticesVBO.push_back(nx);
+	verticesVBO.push_back(ny);
+	verticesVBO.push_back(nz);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// sphere around the z axis, stacks go from +z to -z (same layout as gluSphere)
+///////////////////////////////////////////////////////////////////////////////
+void DuckMesh::addSphere(Part part, int level, float radius)
+{
+	unsigned int base = verticesVBO.size() / 6;
+	partOffset[level][part] = indices.size();
+	int slices = MeshLod::segments(this->slices, level);
+	int stacks = MeshLod::segments(this->stacks, level);
+
+	for (int i = 0; i <= stacks; i++)
+	{
+		float phi = M_PI * i / stacks;
+		for (int j = 0; j <= slices; j++)
+		{
+			float theta = 2.0f * M_PI * j / slices;
+			float nx = sinf(phi) * cosf(theta);
+			float ny = sinf(phi) * sinf(theta);
+			float nz = cosf(phi);
+			addVertex(radius * nx, radius * ny, radius * nz, nx, ny, nz);
+		}
+	}
+
+	// counterclockwise seen from outside
+	for (int i = 0; i < stacks; i++)
+	{
+		for (int j = 0; j < slices; j++)
+		{
+			unsigned int k1 = base + i * (slices + 1) + j;
+			unsigned int k2 = k1 + slices + 1;
+			indices.push_back(k1);
+			indices.push_back(k2);
+			indices.push_back(k1 + 1);
+			indices.push_back(k1 + 1);
+			indices.push_back(k2);
+			indices.push_back(k2 + 1);
+		}
+	}
+	partCount[level][part] = indices.size() - partOffset[level][part];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// open cylinder/cone along +z from z = 0 to z = height (same layout as gluCylinder)
+///////////////////////////////////////////////////////////////////////////////
+void DuckMesh::addCylinder(Part part, int level, float baseRadius, float topRadius, float height)
+{
+	unsigned int base = verticesVBO.size() / 6;
+	partOffset[level][part] = indices.size();
+	int slices = MeshLod::segments(this->slices, level);
+	int stacks = MeshLod::segments(this->stacks, level);
+
+	// slanted side normal
+	float len = sqrtf(height * height + (baseRadius - topRadius) * (baseRadius - topRadius));
+	float xyNormal = height / len;
+	float zNormal = (baseRadius - topRadius) / len;
+
+	for (int i = 0; i <= stacks; i++)
+	{
+		float z = height * i / stacks;
+		float r = baseRadius + (topRadius - baseRadius) * i / stacks;
+		for (int j = 0; j <= slices; j++)
+		{
+			float theta = 2.0f * M_PI * j / slices;
+			float c = cosf(theta);
+			float s = sinf(theta);
+			addVertex(r * c, r * s, z, xyNormal * c, xyNormal * s, zNormal);
+		}
+	}
+
+	// counterclockwise seen from outside
+	for (int i = 0; i < stacks; i++)
+	{
+		for (int j = 0; j < slices; j++)
+		{
+			unsigned int k1 = base + i * (slices + 1) + j;
+			unsigned int k2 = k1 + slices + 1;
+			indices.push_back(k1);
+			indices.push_back(k1 + 1);
+			indices.push_back(k2);
+			indices.push_back(k1 + 1);
+			indices.push_back(k2 + 1);
+			indices.push_back(k2);
+		}
+	}
+	partCount[level][part] = indices.size() - partOffset[level][part];
+}
+
+void DuckMesh::CreateMeshVBO()
+{
+	// no VAO of its own, both go up through GL_ARRAY_BUFFER and setupAttributes() binds
+	// them into the caller's VAO
+	glGenBuffers(2, vbos);
+
+	glBindBuffer(GL_ARRAY_BUFFER, vbos[0]);
+	glBufferData(GL_ARRAY_BUFFER, verticesVBO.size() * sizeof(float), verticesVBO.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, vbos[1]);
+	glBufferData(GL_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void DuckMesh::setupAttributes(GLuint positionAttrib, GLuint normalAttrib)
+{
+	glBindBuffer(GL_ARRAY_BUFFER, vbos[0]);
+	glVertexAttribPointer(positionAttrib, 3, GL_FLOAT, GL_FALSE, VERTEX_STRIDE, BUFFER_OFFSET(0));
+	glEnableVertexAttribArray(positionAttrib);
+	glVertexAttribPointer(normalAttrib, 3, GL_FLOAT, GL_FALSE, VERTEX_STRIDE, BUFFER_OFFSET(3 * sizeof(float)));
+	glEnableVertexAttribArray(normalAttrib);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vbos[1]);
+}
+
+void DuckMesh::drawPartInstanced(Part part, int level, GLsizei instances)
+{
+	glDrawElementsInstanced(GL_TRIANGLES, partCount[level][part], GL_UNSIGNED_INT, BUFFER_OFFSET(partOffset[level][part] * sizeof(GLuint)), instances);
+}
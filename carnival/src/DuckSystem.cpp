@@ -0,0 +1,549 @@
+#include <vector>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DUCK_SYSTEM_SSE2
+#endif
+#ifdef __AVX2__
+#include <immintrin.h>
+#define DUCK_SYSTEM_AVX2
+#endif
+
+#include "Vectors.h"
+#include "Matrices.h"
+#include "DuckSystem.h"
+
+// track the ducks loop around (same values as DuckTarget::animate)
+static const float TRACK_LEFT = -8.0f;
+static const float TRACK_RIGHT = 8.0f;
+static const float TRACK_Y = -0.5f;
+static const float DUCK_SPEED = 0.05f;		// x per step along the track
+static const float SPIN_STEP = 1.0f;		// degrees per step while turning
+static const float FLIP_STEP = 5.0f;		// degrees per step while falling over / getting up
+static const float WAVE_HEIGHT = 0.1f;
+// real time of one step above (the old 12 ms animation timer)
+static const float STEP_SECONDS = 0.012f;
+
+// amounts for one animate() call, the constants above scaled by the steps it covers
+struct StepSizes
+{
+	float speed;
+	float spin;
+	float flip;
+	float wave;
+};
+
+// bullseye center in the duck's model coordinates (1.05 * target depth in front of the body)
+static const float BULLSEYE_OFFSET = -1.05f;
+// bullets within this z distance of the bullseye count as hits
+static const float TARGET_DEPTH = 1.0f;
+// the duck reaches about 3.5 from its origin (head and beak, after the 0.5 scale)
+// and spins about a pivot 2.5 below it, so a sphere on the pivot holds every pose
+static const float SPIN_PIVOT_Y = -2.5f;
+static const float BOUNDS_RADIUS = 6.0f;
+
+///////////////////////////////////////////////////////////////////////////////
+// sin(pi/2 * t) without a libm call so the animate loop stays vectorizable.
+// reduce to [-2, 2) (one period) then an odd polynomial on [-1, 1]
+///////////////////////////////////////////////////////////////////////////////
+static inline float waveSin(float t)
+{
+	// t mod 4 in [-2, 2)
+	float k = floorf((t + 2.0f) * 0.25f);
+	float r = t - 4.0f * k;
+	// sin(pi/2 * r) = sin(pi/2 * (2 - r)) folds (1, 2) and [-2, -1) onto [-1, 1]
+	r = r > 1.0f ? 2.0f - r : r;
+	r = r < -1.0f ? -2.0f - r : r;
+
+	// polynomial fit of sin(pi/2 * r), |error| < 2e-6
+	float r2 = r * r;
+	return r * (1.5707963f + r2 * (-0.6459636f + r2 * (0.0796896f + r2 * (-0.0046737f + r2 * 0.0001515f))));
+}
+
+DuckSystem::DuckSystem() {}
+
+int DuckSystem::addDuck(float x, bool flip, float z)
+{
+	duckX.push_back(x);
+	duckY.push_back(TRACK_Y);
+	duckZ.push_back(z);
+	// if duck should be flipped initially
+	spin.push_back(flip ? -180.0f : 0.0f);
+	state.push_back(flip ? RIGHT_TO_LEFT : LEFT_TO_RIGHT);
+	flipAngle.push_back(0.0f);
+	flipped.push_back(0);
+	prevX.push_back(x);
+	prevY.push_back(TRACK_Y);
+	prevSpin.push_back(spin.back());
+	prevFlipAngle.push_back(0.0f);
+	drawX.push_back(x);
+	drawY.push_back(TRACK_Y);
+	drawSpin.push_back(spin.back());
+	drawFlipAngle.push_back(0.0f);
+	targetX.push_back(0.0f);
+	targetY.push_back(0.0f);
+	targetZ.push_back(0.0f);
+	return size() - 1;
+}
+
+void DuckSystem::reserve(int count)
+{
+	duckX.reserve(count);
+	duckY.reserve(count);
+	duckZ.reserve(count);
+	spin.reserve(count);
+	state.reserve(count);
+	flipAngle.reserve(count);
+	flipped.reserve(count);
+	prevX.reserve(count);
+	prevY.reserve(count);
+	prevSpin.reserve(count);
+	prevFlipAngle.reserve(count);
+	drawX.reserve(count);
+	drawY.reserve(count);
+	drawSpin.reserve(count);
+	drawFlipAngle.reserve(count);
+	targetX.reserve(count);
+	targetY.reserve(count);
+	targetZ.reserve(count);
+}
+
+void DuckSystem::clear()
+{
+	duckX.clear();
+	duckY.clear();
+	duckZ.clear();
+	spin.clear();
+	state.clear();
+	flipAngle.clear();
+	flipped.clear();
+	prevX.clear();
+	prevY.clear();
+	prevSpin.clear();
+	prevFlipAngle.clear();
+	drawX.clear();
+	drawY.clear();
+	drawSpin.clear();
+	drawFlipAngle.clear();
+	targetX.clear();
+	targetY.clear();
+	targetZ.clear();
+}
+
+void DuckSystem::flip(int duck)
+{
+	flipped[duck] = 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// advance one duck one step. Every branch of DuckTarget::animate is computed
+// and the result selected by state, so there are no jumps in the body.
+///////////////////////////////////////////////////////////////////////////////
+static inline void stepDuck(int& s, float& x, float& y, float& sp, float& f, int& isFlipped, const StepSizes& step)
+{
+	bool leftToRight = s == DuckSystem::LEFT_TO_RIGHT;
+	bool rightToLeft = s == DuckSystem::RIGHT_TO_LEFT;
+	bool turn1 = s == DuckSystem::TURN1;
+	bool turn2 = s == DuckSystem::TURN2;
+
+	// move along the track / turn at the ends
+	x += leftToRight ? step.speed : (rightToLeft ? -step.speed : 0.0f);
+	y += leftToRight ? step.wave * waveSin(x - TRACK_LEFT) : 0.0f;
+	sp -= (turn1 || turn2) ? step.spin : 0.0f;
+
+	// reached right end, start turning under the track
+	bool end = leftToRight && x >= TRACK_RIGHT;
+	s = end ? DuckSystem::TURN1 : s;
+	x = end ? TRACK_RIGHT : x;
+	y = end ? TRACK_Y : y;
+
+	// upside down, go back right to left
+	end = turn1 && sp <= -180.0f;
+	s = end ? DuckSystem::RIGHT_TO_LEFT : s;
+	sp = end ? -180.0f : sp;
+	x = end ? TRACK_RIGHT : x;
+
+	// reached left end, start turning back up
+	end = rightToLeft && x <= TRACK_LEFT;
+	s = end ? DuckSystem::TURN2 : s;
+	x = end ? TRACK_LEFT : x;
+
+	// back on top
+	end = turn2 && sp <= -360.0f;
+	s = end ? DuckSystem::LEFT_TO_RIGHT : s;
+	sp = end ? 0.0f : sp;
+	x = end ? TRACK_LEFT : x;
+
+	// hit ducks fall over on top and get back up underneath (uses the new state)
+	float down = f - step.flip;
+	down = down < -90.0f ? -90.0f : down;
+	float up = f + step.flip;
+	bool reset = up >= 0.0f;
+	up = reset ? 0.0f : up;
+	bool falling = isFlipped && s == DuckSystem::LEFT_TO_RIGHT;
+	bool rising = isFlipped && s == DuckSystem::RIGHT_TO_LEFT;
+	f = falling ? down : (rising ? up : f);
+	isFlipped = (rising && reset) ? 0 : isFlipped;
+}
+
+#ifdef DUCK_SYSTEM_SSE2
+///////////////////////////////////////////////////////////////////////////////
+// stepDuck() for four ducks at once. The compilers we build with do not
+// vectorize the mixed int/float selects on their own, so the same steps are
+// written out with SSE2 masks (and/andnot/or instead of blends). Spelled out
+// select by select it was slower than the scalar loop, so this uses what the
+// track guarantees: x never leaves [TRACK_LEFT, TRACK_RIGHT] and turning ducks
+// sit on an end, so every end is a clamp and the next state is state + 1.
+///////////////////////////////////////////////////////////////////////////////
+static inline __m128 select4(__m128 mask, __m128 a, __m128 b)
+{
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+static inline __m128 waveSin4(__m128 t)
+{
+	// t >= -2 on the track, so truncation after the +8 offset is floor
+	__m128 k = _mm_sub_ps(_mm_cvtepi32_ps(_mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(t, _mm_set1_ps(0.25f)), _mm_set1_ps(8.5f)))), _mm_set1_ps(8.0f));
+	__m128 r = _mm_sub_ps(t, _mm_mul_ps(_mm_set1_ps(4.0f), k));
+	// |r| > 1 folds to sign(r) * 2 - r
+	__m128 sign = _mm_and_ps(r, _mm_set1_ps(-0.0f));
+	__m128 folded = _mm_sub_ps(_mm_or_ps(_mm_set1_ps(2.0f), sign), r);
+	r = select4(_mm_cmpgt_ps(_mm_andnot_ps(_mm_set1_ps(-0.0f), r), _mm_set1_ps(1.0f)), folded, r);
+
+	__m128 r2 = _mm_mul_ps(r, r);
+	__m128 p = _mm_add_ps(_mm_set1_ps(-0.0046737f), _mm_mul_ps(r2, _mm_set1_ps(0.0001515f)));
+	p = _mm_add_ps(_mm_set1_ps(0.0796896f), _mm_mul_ps(r2, p));
+	p = _mm_add_ps(_mm_set1_ps(-0.6459636f), _mm_mul_ps(r2, p));
+	p = _mm_add_ps(_mm_set1_ps(1.5707963f), _mm_mul_ps(r2, p));
+	return _mm_mul_ps(r, p);
+}
+
+static void stepDucks4(int count, int* pstate, float* px, float* py, float* pspin, float* pflip, int* pflipped, const StepSizes& step)
+{
+	// loop invariant, kept in registers
+	const __m128 speed = _mm_set1_ps(step.speed);
+	const __m128 spinStep = _mm_set1_ps(step.spin);
+	const __m128 flipStep = _mm_set1_ps(step.flip);
+	const __m128 waveHeight = _mm_set1_ps(step.wave);
+	const __m128 right = _mm_set1_ps(TRACK_RIGHT);
+	const __m128 left = _mm_set1_ps(TRACK_LEFT);
+	const __m128 zero = _mm_setzero_ps();
+
+	for (int i = 0; i + 4 <= count; i += 4)
+	{
+		__m128i s = _mm_loadu_si128((const __m128i*)(pstate + i));
+		__m128 x = _mm_loadu_ps(px + i);
+		__m128 y = _mm_loadu_ps(py + i);
+		__m128 sp = _mm_loadu_ps(pspin + i);
+		__m128 f = _mm_loadu_ps(pflip + i);
+		__m128i isFlipped = _mm_loadu_si128((const __m128i*)(pflipped + i));
+
+		__m128 leftToRight = _mm_castsi128_ps(_mm_cmpeq_epi32(s, _mm_set1_epi32(DuckSystem::LEFT_TO_RIGHT)));
+		__m128 rightToLeft = _mm_castsi128_ps(_mm_cmpeq_epi32(s, _mm_set1_epi32(DuckSystem::RIGHT_TO_LEFT)));
+		__m128 turn1 = _mm_castsi128_ps(_mm_cmpeq_epi32(s, _mm_set1_epi32(DuckSystem::TURN1)));
+		__m128 turn2 = _mm_castsi128_ps(_mm_cmpeq_epi32(s, _mm_set1_epi32(DuckSystem::TURN2)));
+
+		// move along the track / turn at the ends
+		x = _mm_add_ps(x, _mm_sub_ps(_mm_and_ps(leftToRight, speed), _mm_and_ps(rightToLeft, speed)));
+		y = _mm_add_ps(y, _mm_and_ps(leftToRight, _mm_mul_ps(waveHeight, waveSin4(_mm_sub_ps(x, left)))));
+		sp = _mm_sub_ps(sp, _mm_and_ps(_mm_or_ps(turn1, turn2), spinStep));
+
+		// ends of the track and of both turns
+		__m128 endRight = _mm_and_ps(leftToRight, _mm_cmpge_ps(x, right));
+		__m128 endLeft = _mm_and_ps(rightToLeft, _mm_cmple_ps(x, left));
+		__m128 endTurn1 = _mm_and_ps(turn1, _mm_cmple_ps(sp, _mm_set1_ps(-180.0f)));
+		__m128 endTurn2 = _mm_and_ps(turn2, _mm_cmple_ps(sp, _mm_set1_ps(-360.0f)));
+		x = _mm_max_ps(_mm_min_ps(x, right), left);
+		y = select4(endRight, _mm_set1_ps(TRACK_Y), y);
+		sp = select4(endTurn1, _mm_set1_ps(-180.0f), _mm_andnot_ps(endTurn2, sp));
+		// a mask is -1, so subtracting it steps to the next state
+		__m128 end = _mm_or_ps(_mm_or_ps(endRight, endLeft), _mm_or_ps(endTurn1, endTurn2));
+		s = _mm_and_si128(_mm_sub_epi32(s, _mm_castps_si128(end)), _mm_set1_epi32(3));
+
+		// hit ducks fall over on top and get back up underneath (uses the new state)
+		__m128 flipped = _mm_castsi128_ps(_mm_sub_epi32(_mm_setzero_si128(), isFlipped));
+		__m128 falling = _mm_and_ps(flipped, _mm_castsi128_ps(_mm_cmpeq_epi32(s, _mm_set1_epi32(DuckSystem::LEFT_TO_RIGHT))));
+		__m128 rising = _mm_and_ps(flipped, _mm_castsi128_ps(_mm_cmpeq_epi32(s, _mm_set1_epi32(DuckSystem::RIGHT_TO_LEFT))));
+		__m128 down = _mm_max_ps(_mm_sub_ps(f, flipStep), _mm_set1_ps(-90.0f));
+		__m128 up = _mm_add_ps(f, flipStep);
+		__m128 reset = _mm_and_ps(rising, _mm_cmpge_ps(up, zero));
+		up = _mm_min_ps(up, zero);
+		f = select4(falling, down, select4(rising, up, f));
+		isFlipped = _mm_andnot_si128(_mm_castps_si128(reset), isFlipped);
+
+		_mm_storeu_si128((__m128i*)(pstate + i), s);
+		_mm_storeu_ps(px + i, x);
+		_mm_storeu_ps(py + i, y);
+		_mm_storeu_ps(pspin + i, sp);
+		_mm_storeu_ps(pflip + i, f);
+		_mm_storeu_si128((__m128i*)(pflipped + i), isFlipped);
+	}
+}
+#endif
+
+#ifdef DUCK_SYSTEM_AVX2
+///////////////////////////////////////////////////////////////////////////////
+// the same eight at a time, for builds that target AVX2 (CARNIVAL_MARCH=x86-64-v3)
+///////////////////////////////////////////////////////////////////////////////
+static inline __m256 select8(__m256 mask, __m256 a, __m256 b)
+{
+	return _mm256_or_ps(_mm256_and_ps(mask, a), _mm256_andnot_ps(mask, b));
+}
+
+static inline __m256 waveSin8(__m256 t)
+{
+	// t >= -2 on the track, so truncation after the +8 offset is floor
+	__m256 k = _mm256_sub_ps(_mm256_cvtepi32_ps(_mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(t, _mm256_set1_ps(0.25f)), _mm256_set1_ps(8.5f)))), _mm256_set1_ps(8.0f));
+	__m256 r = _mm256_sub_ps(t, _mm256_mul_ps(_mm256_set1_ps(4.0f), k));
+	// |r| > 1 folds to sign(r) * 2 - r
+	__m256 sign = _mm256_and_ps(r, _mm256_set1_ps(-0.0f));
+	__m256 folded = _mm256_sub_ps(_mm256_or_ps(_mm256_set1_ps(2.0f), sign), r);
+	r = select8(_mm256_cmp_ps(_mm256_andnot_ps(_mm256_set1_ps(-0.0f), r), _mm256_set1_ps(1.0f), _CMP_GT_OQ), folded, r);
+
+	__m256 r2 = _mm256_mul_ps(r, r);
+	__m256 p = _mm256_add_ps(_mm256_set1_ps(-0.0046737f), _mm256_mul_ps(r2, _mm256_set1_ps(0.0001515f)));
+	p = _mm256_add_ps(_mm256_set1_ps(0.0796896f), _mm256_mul_ps(r2, p));
+	p = _mm256_add_ps(_mm256_set1_ps(-0.6459636f), _mm256_mul_ps(r2, p));
+	p = _mm256_add_ps(_mm256_set1_ps(1.5707963f), _mm256_mul_ps(r2, p));
+	return _mm256_mul_ps(r, p);
+}
+
+static void stepDucks8(int count, int* pstate, float* px, float* py, float* pspin, float* pflip, int* pflipped, const StepSizes& step)
+{
+	// loop invariant, kept in registers
+	const __m256 speed = _mm256_set1_ps(step.speed);
+	const __m256 spinStep = _mm256_set1_ps(step.spin);
+	const __m256 flipStep = _mm256_set1_ps(step.flip);
+	const __m256 waveHeight = _mm256_set1_ps(step.wave);
+	const __m256 right = _mm256_set1_ps(TRACK_RIGHT);
+	const __m256 left = _mm256_set1_ps(TRACK_LEFT);
+	const __m256 zero = _mm256_setzero_ps();
+
+	for (int i = 0; i + 8 <= count; i += 8)
+	{
+		__m256i s = _mm256_loadu_si256((const __m256i*)(pstate + i));
+		__m256 x = _mm256_loadu_ps(px + i);
+		__m256 y = _mm256_loadu_ps(py + i);
+		__m256 sp = _mm256_loadu_ps(pspin + i);
+		__m256 f = _mm256_loadu_ps(pflip + i);
+		__m256i isFlipped = _mm256_loadu_si256((const __m256i*)(pflipped + i));
+
+		__m256 leftToRight = _mm256_castsi256_ps(_mm256_cmpeq_epi32(s, _mm256_set1_epi32(DuckSystem::LEFT_TO_RIGHT)));
+		__m256 rightToLeft = _mm256_castsi256_ps(_mm256_cmpeq_epi32(s, _mm256_set1_epi32(DuckSystem::RIGHT_TO_LEFT)));
+		__m256 turn1 = _mm256_castsi256_ps(_mm256_cmpeq_epi32(s, _mm256_set1_epi32(DuckSystem::TURN1)));
+		__m256 turn2 = _mm256_castsi256_ps(_mm256_cmpeq_epi32(s, _mm256_set1_epi32(DuckSystem::TURN2)));
+
+		// move along the track / turn at the ends
+		x = _mm256_add_ps(x, _mm256_sub_ps(_mm256_and_ps(leftToRight, speed), _mm256_and_ps(rightToLeft, speed)));
+		y = _mm256_add_ps(y, _mm256_and_ps(leftToRight, _mm256_mul_ps(waveHeight, waveSin8(_mm256_sub_ps(x, left)))));
+		sp = _mm256_sub_ps(sp, _mm256_and_ps(_mm256_or_ps(turn1, turn2), spinStep));
+
+		// ends of the track and of both turns
+		__m256 endRight = _mm256_and_ps(leftToRight, _mm256_cmp_ps(x, right, _CMP_GE_OQ));
+		__m256 endLeft = _mm256_and_ps(rightToLeft, _mm256_cmp_ps(x, left, _CMP_LE_OQ));
+		__m256 endTurn1 = _mm256_and_ps(turn1, _mm256_cmp_ps(sp, _mm256_set1_ps(-180.0f), _CMP_LE_OQ));
+		__m256 endTurn2 = _mm256_and_ps(turn2, _mm256_cmp_ps(sp, _mm256_set1_ps(-360.0f), _CMP_LE_OQ));
+		x = _mm256_max_ps(_mm256_min_ps(x, right), left);
+		y = select8(endRight, _mm256_set1_ps(TRACK_Y), y);
+		sp = select8(endTurn1, _mm256_set1_ps(-180.0f), _mm256_andnot_ps(endTurn2, sp));
+		// a mask is -1, so subtracting it steps to the next state
+		__m256 end = _mm256_or_ps(_mm256_or_ps(endRight, endLeft), _mm256_or_ps(endTurn1, endTurn2));
+		s = _mm256_and_si256(_mm256_sub_epi32(s, _mm256_castps_si256(end)), _mm256_set1_epi32(3));
+
+		// hit ducks fall over on top and get back up underneath (uses the new state)
+		__m256 flipped = _mm256_castsi256_ps(_mm256_sub_epi32(_mm256_setzero_si256(), isFlipped));
+		__m256 falling = _mm256_and_ps(flipped, _mm256_castsi256_ps(_mm256_cmpeq_epi32(s, _mm256_set1_epi32(DuckSystem::LEFT_TO_RIGHT))));
+		__m256 rising = _mm256_and_ps(flipped, _mm256_castsi256_ps(_mm256_cmpeq_epi32(s, _mm256_set1_epi32(DuckSystem::RIGHT_TO_LEFT))));
+		__m256 down = _mm256_max_ps(_mm256_sub_ps(f, flipStep), _mm256_set1_ps(-90.0f));
+		__m256 up = _mm256_add_ps(f, flipStep);
+		__m256 reset = _mm256_and_ps(rising, _mm256_cmp_ps(up, zero, _CMP_GE_OQ));
+		up = _mm256_min_ps(up, zero);
+		f = select8(falling, down, select8(rising, up, f));
+		isFlipped = _mm256_andnot_si256(_mm256_castps_si256(reset), isFlipped);
+
+		_mm256_storeu_si256((__m256i*)(pstate + i), s);
+		_mm256_storeu_ps(px + i, x);
+		_mm256_storeu_ps(py + i, y);
+		_mm256_storeu_ps(pspin + i, sp);
+		_mm256_storeu_ps(pflip + i, f);
+		_mm256_storeu_si256((__m256i*)(pflipped + i), isFlipped);
+	}
+}
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// advance all ducks one step, eight at a time with AVX2, four with SSE2
+///////////////////////////////////////////////////////////////////////////////
+void DuckSystem::animate(bool wave, float steps)
+{
+	const int count = size();
+	float* px = duckX.data();
+	float* py = duckY.data();
+	float* pspin = spin.data();
+	float* pflip = flipAngle.data();
+	int* pstate = state.data();
+	int* pflipped = flipped.data();
+	StepSizes step;
+	step.speed = DUCK_SPEED * steps;
+	step.spin = SPIN_STEP * steps;
+	step.flip = FLIP_STEP * steps;
+	step.wave = wave ? WAVE_HEIGHT * steps : 0.0f;
+
+	int i = 0;
+#ifdef DUCK_SYSTEM_AVX2
+	stepDucks8(count, pstate, px, py, pspin, pflip, pflipped, step);
+	i = count & ~7;
+#endif
+#ifdef DUCK_SYSTEM_SSE2
+	stepDucks4(count - i, pstate + i, px + i, py + i, pspin + i, pflip + i, pflipped + i, step);
+	i += (count - i) & ~3;
+#endif
+	for (; i < count; i++)
+		stepDuck(pstate[i], px[i], py[i], pspin[i], pflip[i], pflipped[i], step);
+}
+
+float DuckSystem::getStepSeconds()
+{
+	return STEP_SECONDS;
+}
+
+void DuckSystem::savePrevious()
+{
+	prevX = duckX;
+	prevY = duckY;
+	prevSpin = spin;
+	prevFlipAngle = flipAngle;
+}
+
+void DuckSystem::interpolate(float alpha)
+{
+	const int count = size();
+	for (int i = 0; i < count; i++)
+	{
+		// spin jumps from -360 back to 0 when a duck is back on top, blend the short way
+		float spinDelta = spin[i] - prevSpin[i];
+		spinDelta = spinDelta > 180.0f ? spinDelta - 360.0f : spinDelta;
+
+		drawX[i] = prevX[i] + alpha * (duckX[i] - prevX[i]);
+		drawY[i] = prevY[i] + alpha * (duckY[i] - prevY[i]);
+		drawSpin[i] = prevSpin[i] + alpha * spinDelta;
+		drawFlipAngle[i] = prevFlipAngle[i] + alpha * (flipAngle[i] - prevFlipAngle[i]);
+	}
+}
+
+Matrix4 DuckSystem::modelMatrix(float x, float y, float z, float spin, float flipAngle)
+{
+	// move to (x, y, z), spin about the pivot under the duck, flip, face the gun, scale;
+	// Matrix4 premultiplies, so the chain is written back to front
+	Matrix4 model;
+	model.scale(0.5f);
+	model.rotateY(180.0f);
+	model.rotateX(flipAngle);
+	model.translate(0.0f, 2.5f, 0.0f);
+	model.rotateZ(spin);
+	model.translate(0.0f, -2.5f, 0.0f);
+	model.translate(x, y, z);
+	return model;
+}
+
+Matrix4 DuckSystem::getModelMatrix(int duck) const
+{
+	return modelMatrix(duckX[duck], duckY[duck], duckZ[duck], spin[duck], flipAngle[duck]);
+}
+
+Vector3 DuckSystem::boundsCenter(float x, float y, float z)
+{
+	return Vector3(x, y + SPIN_PIVOT_Y, z);
+}
+
+float DuckSystem::getBoundsRadius()
+{
+	return BOUNDS_RADIUS;
+}
+
+void DuckSystem::updateTargetCoords(const Matrix4& view)
+{
+	const int count = size();
+	Vector3 bullseye(0.0f, 0.0f, BULLSEYE_OFFSET);
+	for (int i = 0; i < count; i++)
+	{
+		Vector3 target = view * getModelMatrix(i) * bullseye;
+		targetX[i] = target.x;
+		targetY[i] = target.y;
+		targetZ[i] = target.z;
+	}
+}
+
+bool DuckSystem::hit(int duck, Vector3 bulletCoords) const
+{
+	// ducks that are already down cannot be hit again
+	if (flipped[duck])
+		return false;
+
+	// within the bullseye circle in x/y and within the duck's z (tolerance = -1/1)
+	float dx = bulletCoords.x - targetX[duck];
+	float dy = bulletCoords.y - targetY[duck];
+	float dz = bulletCoords.z - targetZ[duck];
+	return dx * dx + dy * dy < targetRadius * targetRadius && dz >= -TARGET_DEPTH && dz <= TARGET_DEPTH;
+}
+
+float DuckSystem::getTargetDepth()
+{
+	return TARGET_DEPTH;
+}
+
+bool DuckSystem::hit(int duck, Vector3 from, Vector3 to) const
+{
+	if (flipped[duck])
+		return false;
+	return sweepTarget(getTargetCoords(duck), targetRadius, from, to);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// continuous version of hit(): does any point of the segment from -> to lie in
+// the hit volume (a cylinder along z around the bullseye, same as the point test).
+// the segment is clipped to the z slab, then the closest x/y approach on the
+// clipped part is compared against the radius
+///////////////////////////////////////////////////////////////////////////////
+bool DuckSystem::sweepTarget(Vector3 center, float radius, Vector3 from, Vector3 to)
+{
+	float t0 = 0.0f;
+	float t1 = 1.0f;
+
+	// clip to center.z - TARGET_DEPTH <= z <= center.z + TARGET_DEPTH
+	float z0 = from.z - center.z;
+	float dz = to.z - from.z;
+	if (dz != 0.0f)
+	{
+		float ta = (-TARGET_DEPTH - z0) / dz;
+		float tb = (TARGET_DEPTH - z0) / dz;
+		if (ta > tb)
+		{
+			float tmp = ta;
+			ta = tb;
+			tb = tmp;
+		}
+		t0 = ta > t0 ? ta : t0;
+		t1 = tb < t1 ? tb : t1;
+		if (t0 > t1)
+			return false;
+	}
+	else if (z0 < -TARGET_DEPTH || z0 > TARGET_DEPTH)
+	{
+		return false;
+	}
+
+	// closest point to the axis on [t0, t1]
+	float x0 = from.x - center.x;
+	float y0 = from.y - center.y;
+	float dx = to.x - from.x;
+	float dy = to.y - from.y;
+	float lengthSq = dx * dx + dy * dy;
+	float t = lengthSq > 0.0f ? -(x0 * dx + y0 * dy) / lengthSq : t0;
+	t = t < t0 ? t0 : (t > t1 ? t1 : t);
+
+	float px = x0 + t * dx;
+	float py = y0 + t * dy;
+	return px * px + py * py < radius * radius;
+}
@@ -0,0 +1,148 @@
+#include <string>
+#include <iostream>
+#include <iomanip>
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+#ifdef _WIN32
+#include <GL/wglew.h> // For wglSwapInterval
+#endif
+
+#define FREEGLUT_STATIC
+#include <GL/freeglut.h>
+
+#include "SimClock.h"
+#include "TraceRecorder.h"
+#include "FrameProfiler.h"
+
+static const char* PASS_NAMES[FrameProfiler::PASS_COUNT] = { "ground", "ducks", "gun+booth", "water", "skybox", "laser", "hud", "swap" };
+
+FrameProfiler::FrameProfiler()
+{
+	for (int s = 0; s < QUERY_FRAMES; s++)
+	{
+		for (int p = 0; p < PASS_COUNT; p++)
+		{
+			queries[s][p] = 0;
+			issued[s][p] = false;
+		}
+	}
+	slot = 0;
+	gpuTiming = false;
+	current = -1;
+	cpuStart = 0.0;
+	droppedQueries = 0;
+	trace = NULL;
+}
+
+void FrameProfiler::init()
+{
+	if (gpuTiming) return;
+	glGenQueries(QUERY_FRAMES * PASS_COUNT, &queries[0][0]);
+	gpuTiming = glGetError() == GL_NO_ERROR;
+}
+
+void FrameProfiler::release()
+{
+	if (!gpuTiming) return;
+	glDeleteQueries(QUERY_FRAMES * PASS_COUNT, &queries[0][0]);
+	for (int s = 0; s < QUERY_FRAMES; s++)
+	{
+		for (int p = 0; p < PASS_COUNT; p++)
+		{
+			queries[s][p] = 0;
+			issued[s][p] = false;
+		}
+	}
+	gpuTiming = false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// read the queries of a slot that are done, without waiting on the rest
+///////////////////////////////////////////////////////////////////////////////
+void FrameProfiler::collect(int slot)
+{
+	for (int p = 0; p < PASS_COUNT; p++)
+	{
+		if (!issued[slot][p]) continue;
+		issued[slot][p] = false;
+
+		GLint available = 0;
+		glGetQueryObjectiv(queries[slot][p], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available)
+		{
+			droppedQueries++;
+			continue;
+		}
+		GLuint64 nanoseconds = 0;
+		glGetQueryObjectui64v(queries[slot][p], GL_QUERY_RESULT, &nanoseconds);
+		gpu[p].add((float)(nanoseconds * 1.0e-6));
+	}
+}
+
+void FrameProfiler::beginFrame()
+{
+	slot = (slot + 1) % QUERY_FRAMES;
+	if (gpuTiming)
+		collect(slot);
+}
+
+void FrameProfiler::begin(Pass pass)
+{
+	current = pass;
+	if (gpuTiming)
+	{
+		glBeginQuery(GL_TIME_ELAPSED, queries[slot][pass]);
+		issued[slot][pass] = true;
+	}
+	cpuStart = SimClock::now();
+}
+
+void FrameProfiler::end()
+{
+	if (current < 0) return;
+	double cpuEnd = SimClock::now();
+	cpu[current].add((float)((cpuEnd - cpuStart) * 1000.0));
+	if (trace)
+		trace->complete(PASS_NAMES[current], "frame", cpuStart, cpuEnd);
+	if (gpuTiming)
+		glEndQuery(GL_TIME_ELAPSED);
+	current = -1;
+}
+
+const char* FrameProfiler::getName(Pass pass)
+{
+	return PASS_NAMES[pass];
+}
+
+void FrameProfiler::print() const
+{
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << "pass        cpu ms min/avg/p99           gpu ms min/avg/p99" << std::endl;
+	for (int p = 0; p < PASS_COUNT; p++)
+	{
+		TimingHistory::Summary c = cpu[p].summarize();
+		TimingHistory::Summary g = gpu[p].summarize();
+		std::cout << std::left << std::setw(12) << PASS_NAMES[p] << std::right
+			<< std::setw(8) << c.min << std::setw(8) << c.avg << std::setw(8) << c.p99 << "      ";
+		if (g.samples > 0)
+			std::cout << std::setw(8) << g.min << std::setw(8) << g.avg << std::setw(8) << g.p99;
+		else
+			std::cout << "       -";
+		std::cout << std::endl;
+	}
+	if (droppedQueries > 0)
+		std::cout << droppedQueries << " GPU timings dropped (not ready after " << QUERY_FRAMES << " frames)" << std::endl;
+	std::cout.unsetf(std::ios_base::floatfield);
+	std::cout << std::setprecision(6);
+}
+
+void FrameProfiler::reset()
+{
+	for (int p = 0; p < PASS_COUNT; p++)
+	{
+		cpu[p].clear();
+		gpu[p].clear();
+	}
+	droppedQueries = 0;
+}
@@ -0,0 +1,54 @@
+#include "FrameScheduler.h"
+
+FrameScheduler::FrameScheduler(double targetFps)
+{
+	nextFrame = 0.0;
+	pending = false;
+	setTargetFps(targetFps);
+	resetStats();
+}
+
+void FrameScheduler::setTargetFps(double fps)
+{
+	frameSeconds = fps > 0.0 ? 1.0 / fps : 0.0;
+}
+
+void FrameScheduler::requestRedraw()
+{
+	requests++;
+	if (pending)
+		coalesced++;
+	pending = true;
+}
+
+bool FrameScheduler::frameDue(double now)
+{
+	if (now < nextFrame)
+		return false;
+	if (!pending)
+	{
+		// nothing changed, the slot goes by without a frame
+		idleSlots++;
+		nextFrame += frameSeconds;
+		if (nextFrame < now)
+			nextFrame = now;
+		return false;
+	}
+	return true;
+}
+
+void FrameScheduler::frameDrawn(double now)
+{
+	frames++;
+	pending = false;
+
+	// next slot on the grid, unless the frame was more than a slot late (idle, stall)
+	nextFrame += frameSeconds;
+	if (nextFrame < now)
+		nextFrame = now + frameSeconds;
+}
+
+void FrameScheduler::resetStats()
+{
+	requests = coalesced = frames = idleSlots = 0;
+}
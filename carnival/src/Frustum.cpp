@@ -0,0 +1,76 @@
+#include <cmath>
+
+#include "Frustum.h"
+
+Frustum::Frustum()
+{
+	// everything visible until set() is called
+	for (int i = 0; i < 6; i++)
+	{
+		planes[i][0] = planes[i][1] = planes[i][2] = 0.0f;
+		planes[i][3] = 1.0f;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Gribb/Hartmann: each plane is row 3 of the matrix plus or minus row 0, 1 or 2
+// (Matrix4 is column major, row r is m[r], m[r + 4], m[r + 8], m[r + 12])
+///////////////////////////////////////////////////////////////////////////////
+void Frustum::set(const Matrix4& viewProjection)
+{
+	const float* m = viewProjection.get();
+	for (int i = 0; i < 6; i++)
+	{
+		int row = i / 2;
+		float sign = (i % 2 == 0) ? 1.0f : -1.0f;
+		for (int c = 0; c < 4; c++)
+			planes[i][c] = m[3 + c * 4] + sign * m[row + c * 4];
+
+		float length = sqrtf(planes[i][0] * planes[i][0] + planes[i][1] * planes[i][1] + planes[i][2] * planes[i][2]);
+		if (length > 0.0f)
+		{
+			for (int c = 0; c < 4; c++)
+				planes[i][c] /= length;
+		}
+	}
+}
+
+bool Frustum::sphereVisible(const Vector3& center, float radius) const
+{
+	for (int i = 0; i < 6; i++)
+	{
+		const float* p = planes[i];
+		if (p[0] * center.x + p[1] * center.y + p[2] * center.z + p[3] < -radius)
+			return false;
+	}
+	return true;
+}
+
+bool Frustum::boxVisible(const Vector3& boxMin, const Vector3& boxMax) const
+{
+	for (int i = 0; i < 6; i++)
+	{
+		// corner furthest along the plane normal
+		const float* p = planes[i];
+		float x = p[0] >= 0.0f ? boxMax.x : boxMin.x;
+		float y = p[1] >= 0.0f ? boxMax.y : boxMin.y;
+		float z = p[2] >= 0.0f ? boxMax.z : boxMin.z;
+		if (p[0] * x + p[1] * y + p[2] * z + p[3] < 0.0f)
+			return false;
+	}
+	return true;
+}
+
+bool Frustum::boxVisible(const Vector3& boxMin, const Vector3& boxMax, const Matrix4& model) const
+{
+	// world box of the transformed box: center moves with the matrix, half extents
+	// grow by the absolute value of the rotation/scale part (Arvo)
+	const float* m = model.get();
+	Vector3 center = (boxMin + boxMax) * 0.5f;
+	Vector3 half = (boxMax - boxMin) * 0.5f;
+	Vector3 worldCenter = model * center;
+	Vector3 worldHalf(fabsf(m[0]) * half.x + fabsf(m[4]) * half.y + fabsf(m[8]) * half.z,
+		fabsf(m[1]) * half.x + fabsf(m[5]) * half.y + fabsf(m[9]) * half.z,
+		fabsf(m[2]) * half.x + fabsf(m[6]) * half.y + fabsf(m[10]) * half.z);
+	return boxVisible(worldCenter - worldHalf, worldCenter + worldHalf);
+}
@@ -1,20 +1,24 @@
+#ifndef GUN_H
+#define GUN_H
+
 #include "Vectors.h"
+#include "Matrices.h"
+#include "BulletPool.h"
+
+class Renderer;
 
 class Gun {
 private:
 	float gunX = 0;
 	float gunY = 0;
 
-	float bulletX = 0;
-	float bulletY = 0;
-	float bulletAngle = 0;
+	// bullets in flight, each remembers the gun pose it was fired from
+	BulletPool bullets;
 
 	const float trajectoryStart = 15.0f;		// starting position of bullet trajectory
-	float trajectory = 0.0f;					// current bullet trajectory offset
 	const float maxDistance = 30.0f;			// max distance bullet can travel
 	const float trajectoryIncrease = 0.8f;		// increase bullet trajectory each frame
 	float theta = 0.0f;							// angle of gun to mimic swiveling arm 
-	const float M_PI = 3.14159265358979323846;
 
 	// bounds
 	const float upperY = 2.5f;
@@ -22,14 +26,6 @@ private:
 	const float upperX = 2.2f;
 	const float lowerX = -2.2f;
 
-	bool inMotion = false;
-
-	// bullet's world coordinates
-	float bulletWorldX = 0.0f;
-	float bulletWorldY = 0.0f;
-	float bulletWorldZ = 0.0f;
-
-
 	// Material properties for drawing
 	float gun_ambient[4] = { 0.05f, 0.05f, 0.05f, 1.0f };
 	float gun_diffuse[4] = { 0.02f, 0.02f, 0.02f, 1.0f };
@@ -42,18 +38,33 @@ private:
 	float bullet_shininess[1] = { 100.0F };
 
 public:
-	Gun();
-	void Gun::draw();
-	void Gun::shoot();
-	void Gun::moveGun(float x, float y);
-	void Gun::moveBullet(); 
+	Gun(int maxBullets = 64);
+	// alpha 0..1 places the bullets between the last two moveBullets()
+	void draw(Renderer& renderer, float alpha = 1.0f);
+	// fire a new bullet, false when all bullets are still in flight
+	bool shoot();
+	void moveGun(float x, float y);
+	// advance every bullet in flight one step
+	void moveBullets();
 	float getGunX() { return gunX; }
 	float getGunY() { return gunY; }
-	bool isInMotion() { return inMotion; }
+	bool isInMotion() { return bullets.getLiveCount() > 0; }
+
+	// bullets in flight, index with 0 .. getBulletCount() - 1
+	int getBulletCount() { return bullets.getLiveCount(); }
+
+	// model transforms of the gun and of a shot bullet, same chains draw() applies
+	Matrix4 getGunMatrix();
+	Matrix4 getBulletMatrix(int bullet) { return getBulletSlotMatrix(bullets.getLiveSlot(bullet), bullets.getTrajectory(bullets.getLiveSlot(bullet))); }
+	Matrix4 getBulletSlotMatrix(int slot, float trajectory);
+
+	// getter for world coordinates (bullet), computed on the CPU so hit detection does not need the renderer
+	Vector3 getBulletWorldCoords(int bullet) { return getBulletMatrix(bullet) * Vector3(0.0f, 0.0f, 0.0f); }
+	// path a bullet travelled in the last moveBullets(), for swept hit detection
+	void getBulletPath(int bullet, Vector3& from, Vector3& to);
 
-	// getter for world coordinates (bullet)
-	Vector3 getBulletWorldCoords() { return Vector3(bulletWorldX, bulletWorldY, bulletWorldZ); }
+	// draw laser for gun (GLuint program, drawing lives in GunDraw.cpp)
+	void drawLaser(Renderer& renderer, unsigned int laserShader);
+};
 
-	// draw laser for gun
-	void drawLaser(GLuint laserShaders);
-};
\ No newline at end of file
+#endif
@@ -0,0 +1,79 @@
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <ctime>
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+#ifdef _WIN32
+#include <GL/wglew.h> // For wglSwapInterval
+#endif
+
+#define FREEGLUT_STATIC
+#include <GL/freeglut.h>
+
+#include "Vectors.h"
+#include "Matrices.h"
+#include "MatrixStack.h"
+#include "Renderer.h"
+#include "Gun.h"
+
+///////////////////////////////////////////////////////////////////////////////
+// GL drawing of the gun, kept apart from Gun.cpp so the simulation builds without GL
+// (expects renderer.begin() to have been called)
+///////////////////////////////////////////////////////////////////////////////
+void Gun::draw(Renderer& renderer, float alpha) {
+	MatrixStack stack;
+	stack.multiply(getGunMatrix());
+	renderer.setMaterial(gun_ambient, gun_diffuse, gun_specular, gun_shininess[0]);
+	stack.push();
+		// handle 
+		stack.scale(1.0f, 1.5f, 1.0f);
+		renderer.setModel(stack.top());
+		renderer.drawSolidCube(1.0f);
+	stack.pop();
+	stack.push();
+		// position barrel to be on top of handle
+		stack.translate(1.0f, 1.0f, 0.0f);
+		stack.scale(3.0f, 1.0f, 1.0f);
+		renderer.setModel(stack.top());
+		renderer.drawSolidCube(1.0f);
+	stack.pop();
+	// bullet 
+	renderer.setMaterial(bullet_ambient, bullet_diffuse, bullet_specular, bullet_shininess[0]);
+	stack.push();
+		// position bullet to be in front of barrel and slightly up
+		stack.translate(3.0f, 1.0f, 0.0f);
+		renderer.setModel(stack.top());
+		renderer.drawSolidSphere(0.5f);
+	stack.pop();
+
+	// bullets that actually got shot
+	for (int i = 0; i < bullets.getLiveCount(); i++) {
+		int slot = bullets.getLiveSlot(i);
+		float last = bullets.getLastTrajectory(slot);
+		renderer.setModel(getBulletSlotMatrix(slot, last + alpha * (bullets.getTrajectory(slot) - last)));
+		renderer.drawSolidSphere(0.5f);
+	}
+}
+
+void Gun::drawLaser(Renderer& renderer, unsigned int laserShader) {
+	if (laserShader == 0) return;
+
+	// use laser shaders
+	glUseProgram(laserShader);
+
+	// apply same translations as in gun, then move laser to where dot should be
+	MatrixStack stack;
+	stack.load(renderer.getProjection() * renderer.getView());
+	stack.multiply(getGunMatrix());
+	stack.translate(20.0f, 1.0f, 0.0f);
+	glUniformMatrix4fv(glGetUniformLocation(laserShader, "modelViewProjectionMatrix"), 1, GL_FALSE, stack.top().get());
+
+	// the shader places the point and sizes it
+	renderer.drawPoint();
+
+	// reset
+	glUseProgram(0);
+}
@@ -0,0 +1,323 @@
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <vector>
+
+#include "Vectors.h"
+#include "Matrices.h"
+#include "Simulation.h"
+#include "InputLog.h"
+
+static const char MAGIC[4] = { 'C', 'I', 'N', 'P' };
+static const unsigned int VERSION = 1;
+
+///////////////////////////////////////////////////////////////////////////////
+// little endian encoding, the same bytes on every build
+///////////////////////////////////////////////////////////////////////////////
+static void putUint(std::vector<unsigned char>& out, unsigned long long value, int bytes)
+{
+	for (int i = 0; i < bytes; i++)
+		out.push_back((unsigned char)(value >> (8 * i)));
+}
+
+static void putVarint(std::vector<unsigned char>& out, unsigned long long value)
+{
+	while (value >= 0x80)
+	{
+		out.push_back((unsigned char)(value | 0x80));
+		value >>= 7;
+	}
+	out.push_back((unsigned char)value);
+}
+
+static void putFloat(std::vector<unsigned char>& out, float value)
+{
+	unsigned int bits;
+	memcpy(&bits, &value, sizeof(bits));
+	putUint(out, bits, 4);
+}
+
+static void putDouble(std::vector<unsigned char>& out, double value)
+{
+	unsigned long long bits;
+	memcpy(&bits, &value, sizeof(bits));
+	putUint(out, bits, 8);
+}
+
+// reads from a loaded file, fails once past its end
+struct Reader
+{
+	const std::vector<unsigned char>& data;
+	size_t pos;
+	bool ok;
+
+	Reader(const std::vector<unsigned char>& data) : data(data), pos(0), ok(true) {}
+
+	unsigned long long getUint(int bytes)
+	{
+		if (pos + bytes > data.size())
+		{
+			ok = false;
+			return 0;
+		}
+		unsigned long long value = 0;
+		for (int i = 0; i < bytes; i++)
+			value |= (unsigned long long)data[pos++] << (8 * i);
+		return value;
+	}
+
+	unsigned long long getVarint()
+	{
+		unsigned long long value = 0;
+		for (int shift = 0; shift < 64; shift += 7)
+		{
+			if (pos >= data.size())
+				break;
+			unsigned char byte = data[pos++];
+			value |= (unsigned long long)(byte & 0x7f) << shift;
+			if (!(byte & 0x80))
+				return value;
+		}
+		ok = false;
+		return 0;
+	}
+
+	float getFloat()
+	{
+		unsigned int bits = (unsigned int)getUint(4);
+		float value;
+		memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+
+	double getDouble()
+	{
+		unsigned long long bits = getUint(8);
+		double value;
+		memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+};
+
+InputLog::InputLog()
+{
+	start(0.01, 1);
+}
+
+void InputLog::start(double tickSeconds, int lanes)
+{
+	this->tickSeconds = tickSeconds;
+	this->lanes = lanes;
+	ticks = 0;
+	inputs.clear();
+	hits.clear();
+	rewind();
+}
+
+void InputLog::record(const Input& input)
+{
+	inputs.push_back(input);
+}
+
+void InputLog::recordTick(const Simulation& simulation)
+{
+	// the tick that just ran
+	long long tick = simulation.getTicks() - 1;
+	const std::vector<int>& tickHits = simulation.getTickHitDucks();
+	for (size_t i = 0; i < tickHits.size(); i++)
+	{
+		Hit hit = { tick, tickHits[i] };
+		hits.push_back(hit);
+	}
+	ticks = simulation.getTicks();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// file
+///////////////////////////////////////////////////////////////////////////////
+bool InputLog::save(const char* fileName) const
+{
+	std::vector<unsigned char> out;
+	out.insert(out.end(), MAGIC, MAGIC + 4);
+	putUint(out, VERSION, 4);
+	putDouble(out, tickSeconds);
+	putUint(out, (unsigned int)lanes, 4);
+	putUint(out, (unsigned long long)ticks, 8);
+	putUint(out, inputs.size(), 4);
+	putUint(out, hits.size(), 4);
+
+	long long tick = 0;
+	for (size_t i = 0; i < inputs.size(); i++)
+	{
+		const Input& input = inputs[i];
+		putVarint(out, (unsigned long long)(input.tick - tick));
+		tick = input.tick;
+		out.push_back((unsigned char)input.type);
+		if (input.type == MOVE)
+		{
+			putFloat(out, input.x);
+			putFloat(out, input.y);
+		}
+		else if (input.type == MOVING)
+			out.push_back(input.x != 0.0f);
+	}
+
+	tick = 0;
+	for (size_t i = 0; i < hits.size(); i++)
+	{
+		putVarint(out, (unsigned long long)(hits[i].tick - tick));
+		tick = hits[i].tick;
+		putVarint(out, (unsigned long long)hits[i].duck);
+	}
+
+	FILE* file = fopen(fileName, "wb");
+	if (!file)
+		return false;
+	bool written = fwrite(out.data(), 1, out.size(), file) == out.size();
+	return fclose(file) == 0 && written;
+}
+
+bool InputLog::load(const char* fileName)
+{
+	FILE* file = fopen(fileName, "rb");
+	if (!file)
+		return false;
+	std::vector<unsigned char> data;
+	unsigned char buffer[4096];
+	size_t count;
+	while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0)
+		data.insert(data.end(), buffer, buffer + count);
+	fclose(file);
+
+	Reader in(data);
+	if (data.size() < 4 || memcmp(data.data(), MAGIC, 4) != 0)
+		return false;
+	in.pos = 4;
+	if (in.getUint(4) != VERSION)
+		return false;
+
+	double tickSeconds = in.getDouble();
+	unsigned long long lanes = in.getUint(4);
+	// a gallery the simulation cannot set up, or a tick that never ends
+	if (!in.ok || !std::isfinite(tickSeconds) || tickSeconds <= 0.0 || lanes < 1 || lanes > (unsigned long long)Simulation::MAX_LANES)
+		return false;
+	start(tickSeconds, (int)lanes);
+	ticks = (long long)in.getUint(8);
+	size_t inputCount = (size_t)in.getUint(4);
+	size_t hitCount = (size_t)in.getUint(4);
+	// a count the file cannot hold means it is broken, not a reason to allocate gigabytes
+	if (!in.ok || inputCount > data.size() || hitCount > data.size())
+		return false;
+
+	inputs.reserve(inputCount);
+	long long tick = 0;
+	for (size_t i = 0; i < inputCount && in.ok; i++)
+	{
+		Input input = { 0, SHOOT, 0.0f, 0.0f };
+		tick += (long long)in.getVarint();
+		input.tick = tick;
+		unsigned int type = (unsigned int)in.getUint(1);
+		if (type == MOVE)
+		{
+			input.type = MOVE;
+			input.x = in.getFloat();
+			input.y = in.getFloat();
+		}
+		else if (type == MOVING)
+		{
+			input.type = MOVING;
+			input.x = in.getUint(1) ? 1.0f : 0.0f;
+		}
+		else if (type != SHOOT)
+			in.ok = false;
+		inputs.push_back(input);
+	}
+
+	hits.reserve(hitCount);
+	tick = 0;
+	for (size_t i = 0; i < hitCount && in.ok; i++)
+	{
+		tick += (long long)in.getVarint();
+		Hit hit = { tick, (int)in.getVarint() };
+		hits.push_back(hit);
+	}
+
+	if (!in.ok)
+	{
+		start(tickSeconds, (int)lanes);
+		return false;
+	}
+	return true;
+}
+
+bool InputLog::isInputLog(const char* fileName)
+{
+	FILE* file = fopen(fileName, "rb");
+	if (!file)
+		return false;
+	char magic[4];
+	bool isLog = fread(magic, 1, 4, file) == 4 && memcmp(magic, MAGIC, 4) == 0;
+	fclose(file);
+	return isLog;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// replay
+///////////////////////////////////////////////////////////////////////////////
+void InputLog::rewind()
+{
+	nextInput = 0;
+	nextHit = 0;
+	mismatchTick = -1;
+}
+
+void InputLog::replay(Simulation& simulation, std::vector<Input>* applied)
+{
+	// in recorded order, same as they came in live
+	long long tick = simulation.getTicks();
+	while (nextInput < inputs.size() && inputs[nextInput].tick <= tick)
+	{
+		if (applied)
+			applied->push_back(inputs[nextInput]);
+		apply(simulation, inputs[nextInput++]);
+	}
+}
+
+bool InputLog::checkHits(const Simulation& simulation)
+{
+	long long tick = simulation.getTicks() - 1;
+	const std::vector<int>& tickHits = simulation.getTickHitDucks();
+
+	// recorded hits of ticks before this one were never hit in the replay
+	bool match = nextHit == hits.size() || hits[nextHit].tick >= tick;
+	while (nextHit < hits.size() && hits[nextHit].tick < tick)
+		nextHit++;
+
+	for (size_t i = 0; i < tickHits.size(); i++)
+	{
+		if (nextHit < hits.size() && hits[nextHit].tick == tick && hits[nextHit].duck == tickHits[i])
+			nextHit++;
+		else
+			match = false;
+	}
+	// recorded for this tick but not hit now
+	while (nextHit < hits.size() && hits[nextHit].tick == tick)
+	{
+		nextHit++;
+		match = false;
+	}
+
+	if (!match && mismatchTick < 0)
+		mismatchTick = tick;
+	return match;
+}
+
+void InputLog::apply(Simulation& simulation, const Input& input)
+{
+	if (input.type == SHOOT)
+		simulation.shoot();
+	else if (input.type == MOVE)
+		simulation.moveGun(input.x, input.y);
+	else
+		simulation.setMoving(input.x != 0.0f);
+}
@@ -0,0 +1,70 @@
+#include <vector>
+
+#include "Vectors.h"
+#include "Matrices.h"
+#include "MatrixStack.h"
+
+MatrixStack::MatrixStack()
+{
+	stack.push_back(Matrix4());
+}
+
+void MatrixStack::push()
+{
+	stack.push_back(stack.back());
+}
+
+void MatrixStack::pop()
+{
+	// the bottom matrix stays, same as popping an empty GL stack is an error and not a crash
+	if (stack.size() > 1)
+		stack.pop_back();
+}
+
+void MatrixStack::loadIdentity()
+{
+	stack.back().identity();
+}
+
+void MatrixStack::load(const Matrix4& m)
+{
+	stack.back() = m;
+}
+
+void MatrixStack::multiply(const Matrix4& m)
+{
+	stack.back() = stack.back() * m;
+}
+
+void MatrixStack::translate(float x, float y, float z)
+{
+	multiply(Matrix4().translate(x, y, z));
+}
+
+void MatrixStack::rotate(float angle, float x, float y, float z)
+{
+	multiply(Matrix4().rotate(angle, x, y, z));
+}
+
+void MatrixStack::scale(float x, float y, float z)
+{
+	multiply(Matrix4().scale(x, y, z));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// camera looking from eye at target, rows are side, up and -forward
+///////////////////////////////////////////////////////////////////////////////
+void MatrixStack::lookAt(const Vector3& eye, const Vector3& target, const Vector3& up)
+{
+	Vector3 f = target - eye;
+	f.normalize();
+	Vector3 s = f.cross(up);
+	s.normalize();
+	Vector3 u = s.cross(f);
+
+	// Matrix4 takes columns
+	multiply(Matrix4(s.x, u.x, -f.x, 0.0f,
+					 s.y, u.y, -f.y, 0.0f,
+					 s.z, u.z, -f.z, 0.0f,
+					 -s.dot(eye), -u.dot(eye), f.dot(eye), 1.0f));
+}
@@ -0,0 +1,43 @@
+#include <cmath>
+
+#include "MeshLod.h"
+
+// smallest screen radius (pixels) that still gets each level, finest first
+static const float LEVEL_RADIUS[MeshLod::LEVELS] = { 48.0f, 16.0f, 6.0f, 0.0f };
+
+int MeshLod::segments(int finest, int level)
+{
+	int n = finest >> level;
+	return n < MIN_SEGMENTS ? MIN_SEGMENTS : n;
+}
+
+float MeshLod::screenRadius(const Matrix4& projection, int viewportHeight, const Vector3& eyeCenter, float radius)
+{
+	// the camera looks down -z; inside or behind the sphere counts as filling the screen
+	float depth = -eyeCenter.z;
+	if (depth <= radius)
+		return (float)viewportHeight;
+
+	// projection[5] is cot(fovY / 2): 1 unit at depth 1 spans projection[5] * height / 2 pixels
+	return radius * projection[5] * 0.5f * viewportHeight / depth;
+}
+
+int MeshLod::select(float screenRadius)
+{
+	for (int level = 0; level < LEVELS - 1; level++)
+	{
+		if (screenRadius >= LEVEL_RADIUS[level])
+			return level;
+	}
+	return LEVELS - 1;
+}
+
+float MeshLod::maxScale(const Matrix4& model)
+{
+	const float* m = model.get();
+	float sx = m[0] * m[0] + m[1] * m[1] + m[2] * m[2];
+	float sy = m[4] * m[4] + m[5] * m[5] + m[6] * m[6];
+	float sz = m[8] * m[8] + m[9] * m[9] + m[10] * m[10];
+	float s = sx > sy ? sx : sy;
+	return sqrtf(s > sz ? s : sz);
+}
@@ -0,0 +1,420 @@
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <cstdio>
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+#ifdef _WIN32
+#include <GL/wglew.h> // For wglSwapInterval
+#endif
+
+#define FREEGLUT_STATIC
+#include <GL/freeglut.h>
+
+#include "Renderer.h"
+#include "PerfHud.h"
+
+#define BUFFER_OFFSET(offset) ((void*)(offset))
+
+// GLUT_BITMAP_8_BY_13 (X11 misc-fixed 8x13), printable ASCII from ' ' to '~'.
+// One byte per row, top row first, most significant bit is the leftmost pixel.
+static const int GLYPH_WIDTH = 8;
+static const int GLYPH_HEIGHT = 13;
+static const int FIRST_GLYPH = 32;
+static const int GLYPH_COUNT = 95;
+static const unsigned char GLYPHS[GLYPH_COUNT][GLYPH_HEIGHT] = {
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },	// space
+	{ 0x00, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00, 0x10, 0x00, 0x00, 0x00 },	// !
+	{ 0x00, 0x24, 0x24, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },	// "
+	{ 0x00, 0x00, 0x24, 0x24, 0x7e, 0x24, 0x7e, 0x24, 0x24, 0x00, 0x00, 0x00, 0x00 },	// #
+	{ 0x00, 0x10, 0x3c, 0x50, 0x50, 0x38, 0x14, 0x14, 0x78, 0x10, 0x00, 0x00, 0x00 },	// $
+	{ 0x00, 0x22, 0x52, 0x24, 0x08, 0x08, 0x10, 0x24, 0x2a, 0x44, 0x00, 0x00, 0x00 },	// %
+	{ 0x00, 0x00, 0x00, 0x30, 0x48, 0x48, 0x30, 0x4a, 0x44, 0x3a, 0x00, 0x00, 0x00 },	// &
+	{ 0x00, 0x38, 0x30, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },	// '
+	{ 0x00, 0x04, 0x08, 0x08, 0x10, 0x10, 0x10, 0x08, 0x08, 0x04, 0x00, 0x00, 0x00 },	// (
+	{ 0x00, 0x20, 0x10, 0x10, 0x08, 0x08, 0x08, 0x10, 0x10, 0x20, 0x00, 0x00, 0x00 },	// )
+	{ 0x00, 0x00, 0x00, 0x24, 0x18, 0x7e, 0x18, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00 },	// *
+	{ 0x00, 0x00, 0x00, 0x10, 0x10, 0x7c, 0x10, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00 },	// +
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x38, 0x30, 0x40, 0x00, 0x00 },	// ,
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x7e, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },	// -
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x38, 0x10, 0x00, 0x00 },	// .
+	{ 0x00, 0x02, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x80, 0x00, 0x00, 0x00 },	// /
+	{ 0x00, 0x18, 0x24, 0x42, 0x42, 0x42, 0x42, 0x42, 0x24, 0x18, 0x00, 0x00, 0x00 },	// 0
+	{ 0x00, 0x10, 0x30, 0x50, 0x10, 0x10, 0x10, 0x10, 0x10, 0x7c, 0x00, 0x00, 0x00 },	// 1
+	{ 0x00, 0x3c, 0x42, 0x42, 0x02, 0x04, 0x18, 0x20, 0x40, 0x7e, 0x00, 0x00, 0x00 },	// 2
+	{ 0x00, 0x7e, 0x02, 0x04, 0x08, 0x1c, 0x02, 0x02, 0x42, 0x3c, 0x00, 0x00, 0x00 },	// 3
+	{ 0x00, 0x04, 0x0c, 0x14, 0x24, 0x44, 0x44, 0x7e, 0x04, 0x04, 0x00, 0x00, 0x00 },	// 4
+	{ 0x00, 0x7e, 0x40, 0x40, 0x5c, 0x62, 0x02, 0x02, 0x42, 0x3c, 0x00, 0x00, 0x00 },	// 5
+	{ 0x00, 0x1c, 0x20, 0x40, 0x40, 0x5c, 0x62, 0x42, 0x42, 0x3c, 0x00, 0x00, 0x00 },	// 6
+	{ 0x00, 0x7e, 0x02, 0x04, 0x08, 0x08, 0x10, 0x10, 0x20, 0x20, 0x00, 0x00, 0x00 },	// 7
+	{ 0x00, 0x3c, 0x42, 0x42, 0x42, 0x3c, 0x42, 0x42, 0x42, 0x3c, 0x00, 0x00, 0x00 },	// 8
+	{ 0x00, 0x3c, 0x42, 0x42, 0x46, 0x3a, 0x02, 0x02, 0x04, 0x38, 0x00, 0x00, 0x00 },	// 9
+	{ 0x00, 0x00, 0x00, 0x10, 0x38, 0x10, 0x00, 0x00, 0x10, 0x38, 0x10, 0x00, 0x00 },	// :
+	{ 0x00, 0x00, 0x00, 0x10, 0x38, 0x10, 0x00, 0x00, 0x38, 0x30, 0x40, 0x00, 0x00 },	// ;
+	{ 0x00, 0x02, 0x04, 0x08, 0x10, 0x20, 0x10, 0x08, 0x04, 0x02, 0x00, 0x00, 0x00 },	// <
+	{ 0x00, 0x00, 0x00, 0x00, 0x7e, 0x00, 0x00, 0x7e, 0x00, 0x00, 0x00, 0x00, 0x00 },	// =
+	{ 0x00, 0x40, 0x20, 0x10, 0x08, 0x04, 0x08, 0x10, 0x20, 0x40, 0x00, 0x00, 0x00 },	// >
+	{ 0x00, 0x3c, 0x42, 0x42, 0x02, 0x04, 0x08, 0x08, 0x00, 0x08, 0x00, 0x00, 0x00 },	// ?
+	{ 0x00, 0x3c, 0x42, 0x42, 0x4e, 0x52, 0x56, 0x4a, 0x40, 0x3c, 0x00, 0x00, 0x00 },	// @
+	{ 0x00, 0x18, 0x24, 0x42, 0x42, 0x42, 0x7e, 0x42, 0x42, 0x42, 0x00, 0x00, 0x00 },	// A
+	{ 0x00, 0xfc, 0x42, 0x42, 0x42, 0x7c, 0x42, 0x42, 0x42, 0xfc, 0x00, 0x00, 0x00 },	// B
+	{ 0x00, 0x3c, 0x42, 0x40, 0x40, 0x40, 0x40, 0x40, 0x42, 0x3c, 0x00, 0x00, 0x00 },	// C
+	{ 0x00, 0xfc, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0xfc, 0x00, 0x00, 0x00 },	// D
+	{ 0x00, 0x7e, 0x40, 0x40, 0x40, 0x78, 0x40, 0x40, 0x40, 0x7e, 0x00, 0x00, 0x00 },	// E
+	{ 0x00, 0x7e, 0x40, 0x40, 0x40, 0x78, 0x40, 0x40, 0x40, 0x40, 0x00, 0x00, 0x00 },	// F
+	{ 0x00, 0x3c, 0x42, 0x40, 0x40, 0x40, 0x4e, 0x42, 0x46, 0x3a, 0x00, 0x00, 0x00 },	// G
+	{ 0x00, 0x42, 0x42, 0x42, 0x42, 0x7e, 0x42, 0x42, 0x42, 0x42, 0x00, 0x00, 0x00 },	// H
+	{ 0x00, 0x7c, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x7c, 0x00, 0x00, 0x00 },	// I
+	{ 0x00, 0x1f, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x44, 0x38, 0x00, 0x00, 0x00 },	// J
+	{ 0x00, 0x42, 0x44, 0x48, 0x50, 0x60, 0x50, 0x48, 0x44, 0x42, 0x00, 0x00, 0x00 },	// K
+	{ 0x00, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x40, 0x7e, 0x00, 0x00, 0x00 },	// L
+	{ 0x00, 0x82, 0x82, 0xc6, 0xaa, 0x92, 0x92, 0x82, 0x82, 0x82, 0x00, 0x00, 0x00 },	// M
+	{ 0x00, 0x42, 0x42, 0x62, 0x52, 0x4a, 0x46, 0x42, 0x42, 0x42, 0x00, 0x00, 0x00 },	// N
+	{ 0x00, 0x3c, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x3c, 0x00, 0x00, 0x00 },	// O
+	{ 0x00, 0x7c, 0x42, 0x42, 0x42, 0x7c, 0x40, 0x40, 0x40, 0x40, 0x00, 0x00, 0x00 },	// P
+	{ 0x00, 0x3c, 0x42, 0x42, 0x42, 0x42, 0x42, 0x52, 0x4a, 0x3c, 0x02, 0x00, 0x00 },	// Q
+	{ 0x00, 0x7c, 0x42, 0x42, 0x42, 0x7c, 0x50, 0x48, 0x44, 0x42, 0x00, 0x00, 0x00 },	// R
+	{ 0x00, 0x3c, 0x42, 0x40, 0x40, 0x3c, 0x02, 0x02, 0x42, 0x3c, 0x00, 0x00, 0x00 },	// S
+	{ 0x00, 0xfe, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00, 0x00, 0x00 },	// T
+	{ 0x00, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x42, 0x3c, 0x00, 0x00, 0x00 },	// U
+	{ 0x00, 0x82, 0x82, 0x44, 0x44, 0x44, 0x28, 0x28, 0x28, 0x10, 0x00, 0x00, 0x00 },	// V
+	{ 0x00, 0x82, 0x82, 0x82, 0x82, 0x92, 0x92, 0x92, 0xaa, 0x44, 0x00, 0x00, 0x00 },	// W
+	{ 0x00, 0x82, 0x82, 0x44, 0x28, 0x10, 0x28, 0x44, 0x82, 0x82, 0x00, 0x00, 0x00 },	// X
+	{ 0x00, 0x82, 0x82, 0x44, 0x28, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00, 0x00, 0x00 },	// Y
+	{ 0x00, 0x7e, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x40, 0x7e, 0x00, 0x00, 0x00 },	// Z
+	{ 0x00, 0x3c, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x3c, 0x00, 0x00, 0x00 },	// [
+	{ 0x00, 0x80, 0x80, 0x40, 0x20, 0x10, 0x08, 0x04, 0x02, 0x02, 0x00, 0x00, 0x00 },	// backslash
+	{ 0x00, 0x78, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x08, 0x78, 0x00, 0x00, 0x00 },	// ]
+	{ 0x00, 0x10, 0x28, 0x44, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },	// ^
+	{ 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfe, 0x00, 0x00 },	// _
+	{ 0x00, 0x38, 0x18, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },	// `
+	{ 0x00, 0x00, 0x00, 0x00, 0x3c, 0x02, 0x3e, 0x42, 0x46, 0x3a, 0x00, 0x00, 0x00 },	// a
+	{ 0x00, 0x40, 0x40, 0x40, 0x5c, 0x62, 0x42, 0x42, 0x62, 0x5c, 0x00, 0x00, 0x00 },	// b
+	{ 0x00, 0x00, 0x00, 0x00, 0x3c, 0x42, 0x40, 0x40, 0x42, 0x3c, 0x00, 0x00, 0x00 },	// c
+	{ 0x00, 0x02, 0x02, 0x02, 0x3a, 0x46, 0x42, 0x42, 0x46, 0x3a, 0x00, 0x00, 0x00 },	// d
+	{ 0x00, 0x00, 0x00, 0x00, 0x3c, 0x42, 0x7e, 0x40, 0x42, 0x3c, 0x00, 0x00, 0x00 },	// e
+	{ 0x00, 0x1c, 0x22, 0x20, 0x20, 0x7c, 0x20, 0x20, 0x20, 0x20, 0x00, 0x00, 0x00 },	// f
+	{ 0x00, 0x00, 0x00, 0x00, 0x3a, 0x44, 0x44, 0x38, 0x40, 0x3c, 0x42, 0x3c, 0x00 },	// g
+	{ 0x00, 0x40, 0x40, 0x40, 0x5c, 0x62, 0x42, 0x42, 0x42, 0x42, 0x00, 0x00, 0x00 },	// h
+	{ 0x00, 0x00, 0x10, 0x00, 0x30, 0x10, 0x10, 0x10, 0x10, 0x7c, 0x00, 0x00, 0x00 },	// i
+	{ 0x00, 0x00, 0x04, 0x00, 0x0c, 0x04, 0x04, 0x04, 0x04, 0x44, 0x44, 0x38, 0x00 },	// j
+	{ 0x00, 0x40, 0x40, 0x40, 0x44, 0x48, 0x70, 0x48, 0x44, 0x42, 0x00, 0x00, 0x00 },	// k
+	{ 0x00, 0x30, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x7c, 0x00, 0x00, 0x00 },	// l
+	{ 0x00, 0x00, 0x00, 0x00, 0xec, 0x92, 0x92, 0x92, 0x92, 0x82, 0x00, 0x00, 0x00 },	// m
+	{ 0x00, 0x00, 0x00, 0x00, 0x5c, 0x62, 0x42, 0x42, 0x42, 0x42, 0x00, 0x00, 0x00 },	// n
+	{ 0x00, 0x00, 0x00, 0x00, 0x3c, 0x42, 0x42, 0x42, 0x42, 0x3c, 0x00, 0x00, 0x00 },	// o
+	{ 0x00, 0x00, 0x00, 0x00, 0x5c, 0x62, 0x42, 0x62, 0x5c, 0x40, 0x40, 0x40, 0x00 },	// p
+	{ 0x00, 0x00, 0x00, 0x00, 0x3a, 0x46, 0x42, 0x46, 0x3a, 0x02, 0x02, 0x02, 0x00 },	// q
+	{ 0x00, 0x00, 0x00, 0x00, 0x5c, 0x22, 0x20, 0x20, 0x20, 0x20, 0x00, 0x00, 0x00 },	// r
+	{ 0x00, 0x00, 0x00, 0x00, 0x3c, 0x42, 0x30, 0x0c, 0x42, 0x3c, 0x00, 0x00, 0x00 },	// s
+	{ 0x00, 0x00, 0x20, 0x20, 0x7c, 0x20, 0x20, 0x20, 0x22, 0x1c, 0x00, 0x00, 0x00 },	// t
+	{ 0x00, 0x00, 0x00, 0x00, 0x44, 0x44, 0x44, 0x44, 0x44, 0x3a, 0x00, 0x00, 0x00 },	// u
+	{ 0x00, 0x00, 0x00, 0x00, 0x44, 0x44, 0x44, 0x28, 0x28, 0x10, 0x00, 0x00, 0x00 },	// v
+	{ 0x00, 0x00, 0x00, 0x00, 0x82, 0x82, 0x92, 0x92, 0xaa, 0x44, 0x00, 0x00, 0x00 },	// w
+	{ 0x00, 0x00, 0x00, 0x00, 0x42, 0x24, 0x18, 0x18, 0x24, 0x42, 0x00, 0x00, 0x00 },	// x
+	{ 0x00, 0x00, 0x00, 0x00, 0x42, 0x42, 0x42, 0x46, 0x3a, 0x02, 0x42, 0x3c, 0x00 },	// y
+	{ 0x00, 0x00, 0x00, 0x00, 0x7e, 0x04, 0x08, 0x10, 0x20, 0x7e, 0x00, 0x00, 0x00 },	// z
+	{ 0x00, 0x0e, 0x10, 0x10, 0x08, 0x30, 0x08, 0x10, 0x10, 0x0e, 0x00, 0x00, 0x00 },	// {
+	{ 0x00, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x00, 0x00, 0x00 },	// |
+	{ 0x00, 0x70, 0x08, 0x08, 0x10, 0x0c, 0x10, 0x08, 0x08, 0x70, 0x00, 0x00, 0x00 },	// }
+	{ 0x00, 0x24, 0x54, 0x48, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },	// ~
+};
+
+// glyph texture: 16 x 6 cells, the cell after the last glyph is solid for panels and bars
+static const int ATLAS_COLUMNS = 16;
+static const int ATLAS_ROWS = 6;
+static const int ATLAS_WIDTH = ATLAS_COLUMNS * GLYPH_WIDTH;
+static const int ATLAS_HEIGHT = ATLAS_ROWS * GLYPH_HEIGHT;
+static const int SOLID_CELL = GLYPH_COUNT;
+
+// layout in pixels
+static const float MARGIN = 8.0f;
+static const float PADDING = 4.0f;
+static const float LINE_HEIGHT = GLYPH_HEIGHT + 2.0f;
+static const float BAR_WIDTH = 2.0f;
+static const float GRAPH_HEIGHT = 40.0f;
+static const float GRAPH_MS = 50.0f;		// frame time at the top of the graph
+static const float TARGET_MS = 1000.0f / 60.0f;
+
+static const double REFRESH_SECONDS = 0.25;
+
+static const unsigned char PANEL_COLOR[4] = { 0, 0, 0, 160 };
+static const unsigned char TEXT_COLOR[4] = { 255, 255, 255, 255 };
+static const unsigned char TARGET_COLOR[4] = { 255, 255, 255, 96 };
+static const unsigned char FAST_COLOR[4] = { 64, 224, 64, 255 };
+static const unsigned char SLOW_COLOR[4] = { 240, 200, 32, 255 };
+static const unsigned char HITCH_COLOR[4] = { 240, 48, 48, 255 };
+
+// Vertex shader: pixel positions (origin top left) to clip space
+const char* vsPerfHudSource = R"(
+#version 330 core
+
+layout(location = 0) in vec2 vertexPosition;
+layout(location = 1) in vec2 vertexTexCoord;
+layout(location = 2) in vec4 vertexColor;
+
+uniform vec2 screenSize;
+
+out vec2 texCoord;
+out vec4 color;
+
+void main(void) {
+    texCoord = vertexTexCoord;
+    color = vertexColor;
+    gl_Position = vec4(vertexPosition.x / screenSize.x * 2.0 - 1.0, 1.0 - vertexPosition.y / screenSize.y * 2.0, 0.0, 1.0);
+}
+)";
+
+// Fragment shader: glyph coverage from the red channel
+const char* fsPerfHudSource = R"(
+#version 330 core
+
+uniform sampler2D glyphs;
+
+in vec2 texCoord;
+in vec4 color;
+
+out vec4 fragColor;
+
+void main(void) {
+    fragColor = vec4(color.rgb, color.a * texture(glyphs, texCoord).r);
+}
+)";
+
+PerfHud::PerfHud()
+{
+	progId = vao = vbo = glyphTexture = 0;
+	uniformScreenSize = uniformGlyphs = -1;
+	visible = false;
+
+	for (int i = 0; i < GRAPH_FRAMES; i++)
+		frameTimes[i] = 0.0f;
+	nextFrame = 0;
+	lastFrame = 0.0;
+
+	lastRefresh = 0.0;
+	refreshTicks = 0;
+	refreshFrames = 0;
+}
+
+PerfHud::~PerfHud()
+{
+	if (vao)
+	{
+		glDeleteBuffers(1, &vbo);
+		glDeleteVertexArrays(1, &vao);
+	}
+	if (glyphTexture)
+		glDeleteTextures(1, &glyphTexture);
+	if (progId)
+		glDeleteProgram(progId);
+}
+
+bool PerfHud::initGLSL()
+{
+	progId = Renderer::createProgram(vsPerfHudSource, fsPerfHudSource, "Perf HUD");
+	if (progId == 0)
+		return false;
+	uniformScreenSize = glGetUniformLocation(progId, "screenSize");
+	uniformGlyphs = glGetUniformLocation(progId, "glyphs");
+
+	createGlyphTexture();
+
+	glGenVertexArrays(1, &vao);
+	glBindVertexArray(vao);
+	glGenBuffers(1, &vbo);
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), BUFFER_OFFSET(0));
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), BUFFER_OFFSET(2 * sizeof(float)));
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), BUFFER_OFFSET(4 * sizeof(float)));
+	glEnableVertexAttribArray(2);
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// one byte per texel (coverage), image rows go down the screen like the glyph rows
+///////////////////////////////////////////////////////////////////////////////
+void PerfHud::createGlyphTexture()
+{
+	std::vector<unsigned char> texels(ATLAS_WIDTH * ATLAS_HEIGHT, 0);
+	for (int cell = 0; cell <= GLYPH_COUNT; cell++)
+	{
+		int left = (cell % ATLAS_COLUMNS) * GLYPH_WIDTH;
+		int top = (cell / ATLAS_COLUMNS) * GLYPH_HEIGHT;
+		for (int row = 0; row < GLYPH_HEIGHT; row++)
+		{
+			unsigned char bits = cell == SOLID_CELL ? 0xFF : GLYPHS[cell][row];
+			for (int column = 0; column < GLYPH_WIDTH; column++)
+			{
+				if (bits & (0x80 >> column))
+					texels[(top + row) * ATLAS_WIDTH + left + column] = 255;
+			}
+		}
+	}
+
+	glGenTextures(1, &glyphTexture);
+	glBindTexture(GL_TEXTURE_2D, glyphTexture);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, ATLAS_WIDTH, ATLAS_HEIGHT, 0, GL_RED, GL_UNSIGNED_BYTE, texels.data());
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void PerfHud::frame(double now)
+{
+	if (lastFrame > 0.0)
+	{
+		frameTimes[nextFrame] = (float)((now - lastFrame) * 1000.0);
+		nextFrame = (nextFrame + 1) % GRAPH_FRAMES;
+	}
+	lastFrame = now;
+	refreshFrames++;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// rebuild the text lines from the counters, rates are over the time since the last refresh
+///////////////////////////////////////////////////////////////////////////////
+void PerfHud::refresh(const Stats& stats, double now)
+{
+	double elapsed = now - lastRefresh;
+	if (lastRefresh > 0.0 && elapsed < REFRESH_SECONDS)
+		return;
+
+	double fps = 0.0, frameMs = 0.0, ticksPerSecond = 0.0;
+	if (lastRefresh > 0.0)
+	{
+		fps = refreshFrames / elapsed;
+		frameMs = refreshFrames > 0 ? elapsed * 1000.0 / refreshFrames : 0.0;
+		ticksPerSecond = (stats.ticks - refreshTicks) / elapsed;
+	}
+	float worstMs = 0.0f;
+	for (int i = 0; i < GRAPH_FRAMES; i++)
+		worstMs = frameTimes[i] > worstMs ? frameTimes[i] : worstMs;
+
+	char line[96];
+	lines.clear();
+	snprintf(line, sizeof(line), "fps %.1f  frame %.2f ms (max %.1f)", fps, frameMs, worstMs);
+	lines.push_back(line);
+	snprintf(line, sizeof(line), "draws %d  triangles %d", stats.drawCalls, stats.triangles);
+	lines.push_back(line);
+	snprintf(line, sizeof(line), "state changes %d  avoided %d", stats.stateChanges, stats.stateChangesAvoided);
+	lines.push_back(line);
+	snprintf(line, sizeof(line), "culled %d  sim ticks/s %.0f", stats.culled, ticksPerSecond);
+	lines.push_back(line);
+	snprintf(line, sizeof(line), "ducks %d (%d up)  bullets %d", stats.ducks, stats.ducksStanding, stats.bullets);
+	lines.push_back(line);
+
+	lastRefresh = now;
+	refreshTicks = stats.ticks;
+	refreshFrames = 0;
+}
+
+void PerfHud::addQuad(float x0, float y0, float x1, float y1, float u0, float v0, float u1, float v1, const unsigned char color[4])
+{
+	Vertex corners[4] = {
+		{ x0, y0, u0, v0, { color[0], color[1], color[2], color[3] } },
+		{ x1, y0, u1, v0, { color[0], color[1], color[2], color[3] } },
+		{ x1, y1, u1, v1, { color[0], color[1], color[2], color[3] } },
+		{ x0, y1, u0, v1, { color[0], color[1], color[2], color[3] } } };
+	static const int order[6] = { 0, 1, 2, 2, 3, 0 };
+	for (int i = 0; i < 6; i++)
+		vertices.push_back(corners[order[i]]);
+}
+
+void PerfHud::addSolid(float x0, float y0, float x1, float y1, const unsigned char color[4])
+{
+	// middle of the solid cell, nearest filtering never reaches a neighbour
+	float u = ((SOLID_CELL % ATLAS_COLUMNS) + 0.5f) * GLYPH_WIDTH / ATLAS_WIDTH;
+	float v = ((SOLID_CELL / ATLAS_COLUMNS) + 0.5f) * GLYPH_HEIGHT / ATLAS_HEIGHT;
+	addQuad(x0, y0, x1, y1, u, v, u, v, color);
+}
+
+void PerfHud::addText(float x, float y, const std::string& text, const unsigned char color[4])
+{
+	for (size_t i = 0; i < text.size(); i++, x += GLYPH_WIDTH)
+	{
+		int glyph = (unsigned char)text[i] - FIRST_GLYPH;
+		if (glyph <= 0 || glyph >= GLYPH_COUNT)
+			continue;	// space and anything outside the font
+		float u0 = (float)((glyph % ATLAS_COLUMNS) * GLYPH_WIDTH) / ATLAS_WIDTH;
+		float v0 = (float)((glyph / ATLAS_COLUMNS) * GLYPH_HEIGHT) / ATLAS_HEIGHT;
+		float u1 = u0 + (float)GLYPH_WIDTH / ATLAS_WIDTH;
+		float v1 = v0 + (float)GLYPH_HEIGHT / ATLAS_HEIGHT;
+		addQuad(x, y, x + GLYPH_WIDTH, y + GLYPH_HEIGHT, u0, v0, u1, v1, color);
+	}
+}
+
+void PerfHud::draw(const Stats& stats, int screenWidth, int screenHeight)
+{
+	if (!visible || progId == 0)
+		return;
+
+	refresh(stats, lastFrame);
+
+	// panel around the text and the graph
+	size_t columns = 0;
+	for (size_t i = 0; i < lines.size(); i++)
+		columns = lines[i].size() > columns ? lines[i].size() : columns;
+	float graphWidth = GRAPH_FRAMES * BAR_WIDTH;
+	float textWidth = columns * GLYPH_WIDTH;
+	float width = (textWidth > graphWidth ? textWidth : graphWidth) + 2.0f * PADDING;
+	float height = lines.size() * LINE_HEIGHT + GRAPH_HEIGHT + 3.0f * PADDING;
+
+	vertices.clear();
+	addSolid(MARGIN, MARGIN, MARGIN + width, MARGIN + height, PANEL_COLOR);
+
+	float x = MARGIN + PADDING;
+	float y = MARGIN + PADDING;
+	for (size_t i = 0; i < lines.size(); i++, y += LINE_HEIGHT)
+		addText(x, y, lines[i], TEXT_COLOR);
+
+	// one bar per frame, oldest on the left, and a line at the 60 fps frame time
+	float graphBottom = y + PADDING + GRAPH_HEIGHT;
+	for (int i = 0; i < GRAPH_FRAMES; i++)
+	{
+		float ms = frameTimes[(nextFrame + i) % GRAPH_FRAMES];
+		if (ms <= 0.0f) continue;
+		float barHeight = (ms < GRAPH_MS ? ms : GRAPH_MS) / GRAPH_MS * GRAPH_HEIGHT;
+		const unsigned char* color = ms <= TARGET_MS * 1.05f ? FAST_COLOR : (ms <= 2.0f * TARGET_MS ? SLOW_COLOR : HITCH_COLOR);
+		float barX = x + i * BAR_WIDTH;
+		addSolid(barX, graphBottom - barHeight, barX + BAR_WIDTH - 1.0f, graphBottom, color);
+	}
+	float targetY = graphBottom - TARGET_MS / GRAPH_MS * GRAPH_HEIGHT;
+	addSolid(x, targetY, x + graphWidth, targetY + 1.0f, TARGET_COLOR);
+
+	// the whole overlay in one draw
+	glDisable(GL_DEPTH_TEST);
+	glDisable(GL_CULL_FACE);
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	glUseProgram(progId);
+	glUniform2f(uniformScreenSize, (float)screenWidth, (float)screenHeight);
+	glUniform1i(uniformGlyphs, 0);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, glyphTexture);
+
+	glBindVertexArray(vao);
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STREAM_DRAW);
+	glDrawArrays(GL_TRIANGLES, 0, (GLsizei)vertices.size());
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glUseProgram(0);
+
+	glDisable(GL_BLEND);
+	glEnable(GL_CULL_FACE);
+	glEnable(GL_DEPTH_TEST);
+}
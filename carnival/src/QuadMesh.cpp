@@ -3,6 +3,7 @@
 #include <fstream>
 #include <vector>
 #include <ctime>
+#include <algorithm>
 
 #define GLEW_STATIC
 #include <GL/glew.h>
@@ -20,22 +21,22 @@
 #include <glm/gtx/quaternion.hpp>
 
 #include "Vectors.h"
+#include "Matrices.h"
+#include "Renderer.h"
 #include "QuadMesh.h"
 
-#define POSITION_ATTRIBUTE 0
-#define NORMAL_ATTRIBUTE 2
-
 #define BUFFER_OFFSET(offset) ((void*)(offset))
-#define MEMBER_OFFSET(s,m) ((char*)NULL + (offsetof(s,m)))
 
 QuadMesh::QuadMesh(int maxMeshSize, float meshDim)
 {
 	minMeshSize =1;
+	meshSize = 0;
 	numVertices = 0;
 	vertices = NULL;
-	numQuads = 0;
-	quads = NULL;
 	numFacesDrawn = 0;
+	vao = 0;
+	vbos[0] = vbos[1] = 0;
+	indexCount = 0;
 	
 	this->maxMeshSize = maxMeshSize < minMeshSize ? minMeshSize : maxMeshSize;
 	this->meshDim = meshDim;
@@ -58,6 +59,16 @@ QuadMesh::QuadMesh(int maxMeshSize, float meshDim)
     
 }
 
+QuadMesh::~QuadMesh()
+{
+	if (vao)
+	{
+		glDeleteBuffers(2, vbos);
+		glDeleteVertexArrays(1, &vao);
+	}
+	FreeMemory();
+}
+
 void QuadMesh::SetMaterial(Vector3 ambient, Vector3 diffuse, Vector3 specular, double shininess)
 {
 	mat_ambient[0] = ambient.x;
@@ -82,52 +93,44 @@ bool QuadMesh::CreateMemory()
 	{
 		return false;
 	}
-
-	quads = new MeshQuad[maxMeshSize*maxMeshSize];
-	if(!quads)
-	{
-		return false;
-	}
     return true;
 }
 		
 ///////////////////////////////////////////////////////////////////////////////
-// add single vertex to array
+// add single interleaved vertex to array
 ///////////////////////////////////////////////////////////////////////////////
-void QuadMesh::addVertex(float x, float y, float z)
+void QuadMesh::addVertex(float x, float y, float z, float nx, float ny, float nz, float u, float v)
 {
 	verticesVBO.push_back(x);
 	verticesVBO.push_back(y);
 	verticesVBO.push_back(z);
+	verticesVBO.push_back(nx);
+	verticesVBO.push_back(ny);
+	verticesVBO.push_back(nz);
+	verticesVBO.push_back(u);
+	verticesVBO.push_back(v);
 }
 
-
-
-///////////////////////////////////////////////////////////////////////////////
-// add single normal to array
-///////////////////////////////////////////////////////////////////////////////
-void QuadMesh::addNormal(float nx, float ny, float nz)
-{
-	normalsVBO.push_back(nx);
-	normalsVBO.push_back(ny);
-	normalsVBO.push_back(nz);
-}
-
-void QuadMesh::addIndices(unsigned int i1, unsigned int i2, unsigned int i3, unsigned int i4)
+void QuadMesh::addIndices(unsigned int i1, unsigned int i2, unsigned int i3)
 {
 	indices.push_back(i1);
 	indices.push_back(i2);
 	indices.push_back(i3);
-	indices.push_back(i4);
 }
 
-bool QuadMesh::InitMesh(int meshSize,Vector3 origin,double meshLength,double meshWidth,Vector3 dir1, Vector3 dir2)
+bool QuadMesh::InitMesh(int meshSize,Vector3 origin,double meshLength,double meshWidth,Vector3 dir1, Vector3 dir2, int textureTiles)
 {
 	Vector3 o;
 	int currentVertex = 0; 	  
 	double sf1,sf2; 
     
 	Vector3 v1,v2;
+
+	if (meshSize < minMeshSize || meshSize > maxMeshSize)
+	{
+		return false;
+	}
+	this->meshSize = meshSize;
 	
 	v1.x = dir1.x;
 	v1.y = dir1.y;
@@ -149,11 +152,7 @@ bool QuadMesh::InitMesh(int meshSize,Vector3 origin,double meshLength,double mes
 	
 	// Starts at front left corner of mesh 
 	o.set(origin.x,origin.y,origin.z);
-
-	std::vector<float>().swap(verticesVBO);
-	std::vector<float>().swap(normalsVBO);
-	std::vector<unsigned int>().swap(indices);
-	
+	boundsMin = boundsMax = o;
 
 	for(int i=0; i< meshSize+1; i++)
 	{
@@ -164,151 +163,101 @@ bool QuadMesh::InitMesh(int meshSize,Vector3 origin,double meshLength,double mes
 			meshpt.y = o.y + j * v1.y;
 			meshpt.z = o.z + j * v1.z;
 			vertices[currentVertex].position.set(meshpt.x, meshpt.y, meshpt.z);
-
-			addVertex(meshpt.x, meshpt.y, meshpt.z);
 			currentVertex++;
+
+			boundsMin.set(std::min(boundsMin.x, meshpt.x), std::min(boundsMin.y, meshpt.y), std::min(boundsMin.z, meshpt.z));
+			boundsMax.set(std::max(boundsMax.x, meshpt.x), std::max(boundsMax.y, meshpt.y), std::max(boundsMax.z, meshpt.z));
 		}
 		// go to next row in mesh (negative z direction)
 		o += v2;
 	}
-	
-	// Build Quad Polygons
-	numQuads=(meshSize)*(meshSize);
-	int currentQuad=0;
 
-	for(int j=0; j < meshSize; j++)
+	this->ComputeNormals();
+
+	// Interleaved vertex buffer, texture coords run past 1 and rely on GL_REPEAT
+	/* imagine mesh as size j,k, then
+		 j+1,k  ---- j+1,k+1
+		 |              |
+		 |              |
+		 j,k -------- j,k+1
+	*/
+	std::vector<float>().swap(verticesVBO);
+	std::vector<unsigned int>().swap(indices);
+	verticesVBO.reserve(numVertices * Renderer::VERTEX_FLOATS);
+	indices.reserve(meshSize * meshSize * 6);
+
+	float tileScale = (float)textureTiles / meshSize;
+	for (int j = 0; j < meshSize + 1; j++)
 	{
-		for(int k=0; k < meshSize; k++)
+		for (int k = 0; k < meshSize + 1; k++)
 		{
-			// Counterclockwise order
-			quads[currentQuad].vertices[0] = &vertices[j * (meshSize + 1) + k]; // bottom left
-			quads[currentQuad].vertices[1] = &vertices[j * (meshSize + 1) + k + 1]; // bottom right
-			quads[currentQuad].vertices[2] = &vertices[(j + 1) * (meshSize + 1) + k + 1]; // top right
-			quads[currentQuad].vertices[3] = &vertices[(j + 1) * (meshSize + 1) + k]; // top left 
-			currentQuad++;
-			addIndices(j * (meshSize + 1) + k, j * (meshSize + 1) + k + 1,
-				      (j + 1) * (meshSize + 1) + k + 1, (j + 1) * (meshSize + 1) + k);
-			
+			const MeshVertex& vertex = vertices[j * (meshSize + 1) + k];
+			addVertex(vertex.position.x, vertex.position.y, vertex.position.z,
+				vertex.normal.x, vertex.normal.y, vertex.normal.z,
+				k * tileScale, 1.0f - j * tileScale);
 		}
 	}
 
-    this->ComputeNormals();
-	for (int j = 0; j < currentVertex; j++)
-	{
-		addNormal(vertices[j].normal.x, vertices[j].normal.y, vertices[j].normal.z);
-	}
-	return true;
-}
-
-// Immediate Mode Draw - used for texture mapping
-void QuadMesh::DrawMesh(int meshSize)
-{
-	int currentQuad=0;
-
-	glMaterialfv(GL_FRONT, GL_AMBIENT, mat_ambient);
-	glMaterialfv(GL_FRONT, GL_SPECULAR, mat_specular);
-	glMaterialfv(GL_FRONT, GL_DIFFUSE, mat_diffuse);
-	glMaterialfv(GL_FRONT, GL_SHININESS, mat_shininess);
-
+	// Build Quads as two triangles each
 	for(int j=0; j < meshSize; j++)
 	{
 		for(int k=0; k < meshSize; k++)
 		{
-			glBegin(GL_QUADS);
-
-			// texture coords - replicate this in shaders
-			/* imagine mesh as size j,k, then
-				 j,k+1   ---- j+1,k+1
-				 |              |
-				 |              |
-				 j,k -------- j+1,k
-
-				Bottom left: j, k
-				Bottom right: j+1, k
-				Top left: j, k+1
-				Top right: j+1, k+1
-			*/
-			
-			// Top left 
-			glNormal3f(quads[currentQuad].vertices[0]->normal.x,
-				       quads[currentQuad].vertices[0]->normal.y,
-					   quads[currentQuad].vertices[0]->normal.z);
-			// set texture coord for quad (top left) 
-			glTexCoord2f(0, 1);
-			glVertex3f(quads[currentQuad].vertices[0]->position.x,
-				       quads[currentQuad].vertices[0]->position.y,
-					   quads[currentQuad].vertices[0]->position.z);
-			
-			// Top right 
-			glNormal3f(quads[currentQuad].vertices[1]->normal.x,
-				       quads[currentQuad].vertices[1]->normal.y,
-					   quads[currentQuad].vertices[1]->normal.z);
-			// set texture coord for quad (top right)
-			glTexCoord2f(1, 1);
-			glVertex3f(quads[currentQuad].vertices[1]->position.x,
-				       quads[currentQuad].vertices[1]->position.y,
-					   quads[currentQuad].vertices[1]->position.z);
-			
-			// Bottom right
-			glNormal3f(quads[currentQuad].vertices[2]->normal.x,
-				       quads[currentQuad].vertices[2]->normal.y,
-					   quads[currentQuad].vertices[2]->normal.z);
-			// set texture coord for quad (bottom right)
-			glTexCoord2f(1, 0);
-			glVertex3f(quads[currentQuad].vertices[2]->position.x,
-				       quads[currentQuad].vertices[2]->position.y,
-					   quads[currentQuad].vertices[2]->position.z);
-			
-			// Bottom left 
-			glNormal3f(quads[currentQuad].vertices[3]->normal.x,
-				       quads[currentQuad].vertices[3]->normal.y,
-					   quads[currentQuad].vertices[3]->normal.z);
-			// set texture coord for quad (bottom left) 
-			glTexCoord2f(0, 0);
-			glVertex3f(quads[currentQuad].vertices[3]->position.x,
-				       quads[currentQuad].vertices[3]->position.y,
-					   quads[currentQuad].vertices[3]->position.z);
-			glEnd();
-			currentQuad++;
+			// Counterclockwise order
+			unsigned int bottomLeft = j * (meshSize + 1) + k;
+			unsigned int bottomRight = j * (meshSize + 1) + k + 1;
+			unsigned int topRight = (j + 1) * (meshSize + 1) + k + 1;
+			unsigned int topLeft = (j + 1) * (meshSize + 1) + k;
+			addIndices(bottomLeft, bottomRight, topRight);
+			addIndices(topRight, topLeft, bottomLeft);
 		}
 	}
+	indexCount = (GLsizei)indices.size();
+	return true;
 }
 
-// VBO Mode Draw
-void QuadMesh::DrawMeshVBO(int meshSize)
+void QuadMesh::CreateMeshVBO()
 {
+	if (verticesVBO.empty())
+		return;
 
-	//glMaterialfv(GL_FRONT, GL_AMBIENT, mat_ambient);
-	//glMaterialfv(GL_FRONT, GL_SPECULAR, mat_specular);
-	//glMaterialfv(GL_FRONT, GL_DIFFUSE, mat_diffuse);
-	//glMaterialfv(GL_FRONT, GL_SHININESS, mat_shininess);
-	glBindVertexArray(vao);
-	glDrawElements(GL_QUADS, indices.size(), GL_UNSIGNED_INT, NULL);
-	
-}
-void QuadMesh::CreateMeshVBO(int meshSize, GLint attribVertexPosition,GLint attribVertexNormal)
-{
-	glGenVertexArrays(1, &vao);
+	const int stride = Renderer::VERTEX_FLOATS * sizeof(GLfloat);
+	if (!vao)
+	{
+		glGenVertexArrays(1, &vao);
+		glGenBuffers(2, vbos);
+	}
 	glBindVertexArray(vao);
-	glGenBuffers(3, vbos);
-
 	glBindBuffer(GL_ARRAY_BUFFER, vbos[0]);
-	glBufferData(GL_ARRAY_BUFFER, (unsigned int)verticesVBO.size() * sizeof(float), verticesVBO.data(), GL_STATIC_DRAW);
-	glVertexAttribPointer(attribVertexPosition, 3, GL_FLOAT, GL_FALSE, 0, BUFFER_OFFSET(0));
-	glEnableVertexAttribArray(attribVertexPosition);// POSITION_ATTRIBUTE);
-
-	glBindBuffer(GL_ARRAY_BUFFER, vbos[1]);
-	glBufferData(GL_ARRAY_BUFFER, normalsVBO.size() * sizeof(float), normalsVBO.data(), GL_STATIC_DRAW);
-	glVertexAttribPointer(attribVertexNormal, 3, GL_FLOAT, GL_TRUE, 0, BUFFER_OFFSET(0));
-	glEnableVertexAttribArray(attribVertexNormal);// NORMAL_ATTRIBUTE);
-
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vbos[2]);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
-
+	glBufferData(GL_ARRAY_BUFFER, verticesVBO.size() * sizeof(GLfloat), verticesVBO.data(), GL_STATIC_DRAW);
+	glVertexAttribPointer(Renderer::POSITION, 3, GL_FLOAT, GL_FALSE, stride, BUFFER_OFFSET(0));
+	glEnableVertexAttribArray(Renderer::POSITION);
+	glVertexAttribPointer(Renderer::NORMAL, 3, GL_FLOAT, GL_FALSE, stride, BUFFER_OFFSET(3 * sizeof(GLfloat)));
+	glEnableVertexAttribArray(Renderer::NORMAL);
+	glVertexAttribPointer(Renderer::TEXCOORD, 2, GL_FLOAT, GL_FALSE, stride, BUFFER_OFFSET(6 * sizeof(GLfloat)));
+	glEnableVertexAttribArray(Renderer::TEXCOORD);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vbos[1]);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
 
 	glBindVertexArray(0);
 	glBindBuffer(GL_ARRAY_BUFFER, 0);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+	// the GPU has its own copy now
+	std::vector<float>().swap(verticesVBO);
+	std::vector<unsigned int>().swap(indices);
+}
+
+// VBO Draw - the whole grid in one call
+void QuadMesh::DrawMesh(Renderer& renderer)
+{
+	if (!vao || !renderer.isVisible(boundsMin, boundsMax, Matrix4()))
+		return;
+
+	renderer.setMaterial(mat_ambient, mat_diffuse, mat_specular, mat_shininess[0]);
+	renderer.setModel(Matrix4());
+	renderer.drawIndexed(vao, GL_TRIANGLES, indexCount, GL_UNSIGNED_INT);
+	numFacesDrawn = indexCount / 3;
 }
 
 void QuadMesh::FreeMemory()
@@ -317,31 +266,34 @@ void QuadMesh::FreeMemory()
 		delete [] vertices;
 	vertices=NULL;
 	numVertices=0;
-
-	if(quads)
-		delete [] quads;
-	quads=NULL;
-	numQuads=0;
 }
 
+// average the corner normals of every quad touching a vertex
 void QuadMesh::ComputeNormals() 
 {
-	int currentQuad=0;
+	int rowLength = meshSize + 1;
 
-	for(int j=0; j< this->maxMeshSize; j++)
+	for (int i = 0; i < numVertices; i++)
 	{
-		for(int k=0; k< this->maxMeshSize; k++)
+		vertices[i].normal.set(0, 0, 0);
+	}
+
+	for(int j=0; j< this->meshSize; j++)
+	{
+		for(int k=0; k< this->meshSize; k++)
 		{
-			Vector3 n0,n1,n2,n3,e0,e1,e2,e3,ne0,ne1,ne2,ne3;
-			
-			quads[currentQuad].vertices[0]->normal.set(0,0,0);
-			quads[currentQuad].vertices[1]->normal.set(0,0,0);
-			quads[currentQuad].vertices[2]->normal.set(0,0,0);
-			quads[currentQuad].vertices[3]->normal.set(0,0,0);
-			e0 = quads[currentQuad].vertices[1]->position - quads[currentQuad].vertices[0]->position; 
-			e1 = quads[currentQuad].vertices[2]->position - quads[currentQuad].vertices[1]->position; 
-			e2 = quads[currentQuad].vertices[3]->position - quads[currentQuad].vertices[2]->position; 
-			e3 = quads[currentQuad].vertices[0]->position - quads[currentQuad].vertices[3]->position; 
+			Vector3 n0,n1,n2,n3,e0,e1,e2,e3;
+			MeshVertex* quad[4] = {
+				&vertices[j * rowLength + k],
+				&vertices[j * rowLength + k + 1],
+				&vertices[(j + 1) * rowLength + k + 1],
+				&vertices[(j + 1) * rowLength + k]
+			};
+
+			e0 = quad[1]->position - quad[0]->position; 
+			e1 = quad[2]->position - quad[1]->position; 
+			e2 = quad[3]->position - quad[2]->position; 
+			e3 = quad[0]->position - quad[3]->position; 
 			e0.normalize();
 			e1.normalize();
 			e2.normalize();
@@ -349,27 +301,24 @@ void QuadMesh::ComputeNormals()
 			
 			n0 = e0.cross(-e3);
 			n0.normalize();
-			quads[currentQuad].vertices[0]->normal += n0;
+			quad[0]->normal += n0;
 			
 			n1 = e1.cross(-e0);
 			n1.normalize();
-			quads[currentQuad].vertices[1]->normal += n1;
+			quad[1]->normal += n1;
 
 			n2 = e2.cross(-e1);
 			n2.normalize();
-			quads[currentQuad].vertices[2]->normal += n2;
+			quad[2]->normal += n2;
 
 			n3 = e3.cross(-e2);
 			n3.normalize();
-			quads[currentQuad].vertices[3]->normal += n3;
-			
-			quads[currentQuad].vertices[0]->normal.normalize();
-			quads[currentQuad].vertices[1]->normal.normalize();
-			quads[currentQuad].vertices[2]->normal.normalize();
-			quads[currentQuad].vertices[3]->normal.normalize();
-			
-
-			currentQuad++;
+			quad[3]->normal += n3;
 		}
 	}
+
+	for (int i = 0; i < numVertices; i++)
+	{
+		vertices[i].normal.normalize();
+	}
 }
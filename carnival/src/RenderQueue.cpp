@@ -0,0 +1,55 @@
+#include <algorithm>
+#include <cstring>
+
+#include "RenderQueue.h"
+
+unsigned long long RenderQueue::makeKey(unsigned int program, unsigned int texture, int material)
+{
+	// 16 bits of program, 24 of texture, 24 of material: handles are small sequential names
+	return ((unsigned long long)(program & 0xFFFF) << 48) |
+		((unsigned long long)(texture & 0xFFFFFF) << 24) |
+		(unsigned long long)(material & 0xFFFFFF);
+}
+
+int RenderQueue::addMaterial(const Material& material)
+{
+	int index = findMaterial(material);
+	if (index >= 0)
+		return index;
+	materials.push_back(material);
+	return (int)materials.size() - 1;
+}
+
+int RenderQueue::findMaterial(const Material& material) const
+{
+	// a handful of materials per scene, a linear search is cheaper than hashing
+	for (size_t i = 0; i < materials.size(); i++)
+	{
+		if (memcmp(&materials[i], &material, sizeof(Material)) == 0)
+			return (int)i;
+	}
+	return -1;
+}
+
+void RenderQueue::submit(unsigned int program, unsigned int texture, int material,
+	unsigned int vao, unsigned int mode, int count, unsigned int indexType, unsigned int indexOffset, const Matrix4& model)
+{
+	Item item;
+	item.key = makeKey(program, texture, material);
+	item.program = program;
+	item.texture = texture;
+	item.material = material;
+	item.vao = vao;
+	item.mode = mode;
+	item.count = count;
+	item.indexType = indexType;
+	item.indexOffset = indexOffset;
+	item.model = model;
+	items.push_back(item);
+}
+
+void RenderQueue::sort()
+{
+	std::stable_sort(items.begin(), items.end(),
+		[](const Item& a, const Item& b) { return a.key < b.key; });
+}
@@ -0,0 +1,641 @@
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <ctime>
+#include <cmath>
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+#ifdef _WIN32
+#include <GL/wglew.h> // For wglSwapInterval
+#endif
+
+#define FREEGLUT_STATIC
+#include <GL/freeglut.h>
+
+#include "Vectors.h"
+#include "Matrices.h"
+#include "MeshLod.h"
+#include "Renderer.h"
+
+#define BUFFER_OFFSET(offset) ((void*)(offset))
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// position (3) + normal (3) for the solids
+static const int SOLID_VERTEX_STRIDE = 6 * sizeof(float);
+
+// glutSolidSphere(r, 50, 50) tessellation, the finest level
+static const int SPHERE_SEGMENTS = 50;
+
+// Vertex shader: everything in eye space, like the fixed-function pipeline lit it
+const char* vsLitSource = R"(
+#version 330 core
+
+layout(location = 0) in vec3 vertexPosition;
+layout(location = 1) in vec3 vertexNormal;
+layout(location = 2) in vec2 vertexTexCoord;
+
+uniform mat4 modelViewMatrix;
+uniform mat4 normalMatrix;                          // inverse transpose of modelViewMatrix
+uniform mat4 projectionMatrix;
+
+out vec3 position;
+out vec3 normal;
+out vec2 texCoord;
+
+void main(void)
+{
+    vec4 eyePosition = modelViewMatrix * vec4(vertexPosition, 1.0);
+    gl_Position = projectionMatrix * eyePosition;
+    position = eyePosition.xyz;
+    normal = mat3(normalMatrix) * vertexNormal;
+    texCoord = vertexTexCoord;
+}
+)";
+
+// Put in front of the fragment shader of every lit program by litFragmentSource(), after
+// "#version" and the MAX_MATERIALS define: the shared Light and Materials blocks and
+// light 0 on a material (blinn-phong) the way the fixed-function pipeline lit it.
+static const char* litPreludeSource = R"(
+// light 0, Renderer::LIGHT_BLOCK
+layout(std140) uniform Light
+{
+    vec4 lightPosition;                             // eye space
+    vec4 lightAmbient;
+    vec4 lightDiffuse;
+    vec4 lightSpecular;
+};
+
+struct MaterialData
+{
+    vec4 ambient;
+    vec4 diffuse;
+    vec4 specular;
+    vec4 shininess;                                 // in x
+};
+
+// every material of the scene, Renderer::MATERIAL_BLOCK
+layout(std140) uniform Materials
+{
+    MaterialData materials[MAX_MATERIALS];
+};
+
+uniform int materialIndex;
+
+// GL_LIGHT_MODEL_AMBIENT default
+const vec3 sceneAmbient = vec3(0.2);
+
+// lit color of a surface point, eye space position and normal
+vec3 blinnPhong(MaterialData material, vec3 eyePosition, vec3 eyeNormal)
+{
+    vec3 norm = normalize(eyeNormal);
+    vec3 light;
+    if (lightPosition.w == 0.0)
+    {
+        light = normalize(lightPosition.xyz);
+    }
+    else
+    {
+        light = normalize(lightPosition.xyz - eyePosition);
+    }
+    vec3 view = normalize(-eyePosition);
+    vec3 halfv = normalize(light + view);
+
+    vec3 color = (sceneAmbient + lightAmbient.rgb) * material.ambient.rgb;
+    float dotNL = max(dot(norm, light), 0.0);
+    color += lightDiffuse.rgb * material.diffuse.rgb * dotNL;
+    if (dotNL > 0.0)
+    {
+        float dotNH = max(dot(norm, halfv), 0.0);
+        color += pow(dotNH, material.shininess.x) * lightSpecular.rgb * material.specular.rgb;
+    }
+    return color;
+}
+)";
+
+// Fragment shader: light 0 with the material, texture modulates like GL_MODULATE
+const char* fsLitSource = R"(
+in vec3 position;
+in vec3 normal;
+in vec2 texCoord;
+
+uniform int useTexture;
+uniform sampler2D texture0;
+
+out vec4 fragColor;
+
+void main()
+{
+    MaterialData material = materials[materialIndex];
+    vec4 result = vec4(blinnPhong(material, position, normal), material.diffuse.a);
+    if (useTexture != 0)
+        result *= texture(texture0, texCoord);
+    fragColor = result;
+}
+)";
+
+Renderer::Renderer()
+{
+	progId = 0;
+	uniformModelViewMatrix = uniformNormalMatrix = uniformProjectionMatrix = -1;
+	uniformMaterialIndex = uniformUseTexture = uniformTexture = -1;
+	lightUbo = materialUbo = 0;
+	uploadedMaterials = 0;
+	materialsFull = false;
+
+	cubeVao = sphereVao = emptyVao = 0;
+	cubeVbos[0] = cubeVbos[1] = 0;
+	sphereVbos[0] = sphereVbos[1] = 0;
+	cubeIndexCount = 0;
+	for (int level = 0; level < MeshLod::LEVELS; level++)
+		sphereIndexCount[level] = sphereIndexOffset[level] = 0;
+	viewportWidth = viewportHeight = 0;
+	texture = 0;
+	resetStats();
+
+	// until the first setMaterial(): the fixed-function default material
+	Material defaultMaterial = { { 0.2f, 0.2f, 0.2f, 1.0f }, { 0.8f, 0.8f, 0.8f, 1.0f }, { 0.0f, 0.0f, 0.0f, 1.0f }, 0.0f };
+	material = queue.addMaterial(defaultMaterial);
+
+	// fixed-function light 0 defaults until setLight()
+	float position[4] = { 0.0f, 0.0f, 1.0f, 0.0f };
+	float ambient[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+	float white[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+	setLight(position, ambient, white, white);
+}
+
+Renderer::~Renderer()
+{
+	if (cubeVao)
+	{
+		glDeleteBuffers(2, cubeVbos);
+		glDeleteBuffers(2, sphereVbos);
+		glDeleteVertexArrays(1, &cubeVao);
+		glDeleteVertexArrays(1, &sphereVao);
+		glDeleteVertexArrays(1, &emptyVao);
+	}
+	if (lightUbo)
+	{
+		glDeleteBuffers(1, &lightUbo);
+		glDeleteBuffers(1, &materialUbo);
+	}
+	if (progId)
+		glDeleteProgram(progId);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// compile and link, the log goes to stdout under the given name
+///////////////////////////////////////////////////////////////////////////////
+GLuint Renderer::createProgram(const char* vsSource, const char* fsSource, const char* name)
+{
+	const int MAX_LENGTH = 2048;
+	char log[MAX_LENGTH];
+	int logLength = 0;
+
+	GLuint vsId = glCreateShader(GL_VERTEX_SHADER);
+	GLuint fsId = glCreateShader(GL_FRAGMENT_SHADER);
+	glShaderSource(vsId, 1, &vsSource, NULL);
+	glShaderSource(fsId, 1, &fsSource, NULL);
+	glCompileShader(vsId);
+	glCompileShader(fsId);
+
+	int vsStatus, fsStatus;
+	glGetShaderiv(vsId, GL_COMPILE_STATUS, &vsStatus);
+	glGetShaderiv(fsId, GL_COMPILE_STATUS, &fsStatus);
+	if (vsStatus == GL_FALSE || fsStatus == GL_FALSE)
+	{
+		GLuint failed = vsStatus == GL_FALSE ? vsId : fsId;
+		glGetShaderInfoLog(failed, MAX_LENGTH, &logLength, log);
+		std::cout << "===== " << name << (failed == vsId ? " Vertex" : " Fragment") << " Shader Log =====\n" << log << std::endl;
+		glDeleteShader(vsId);
+		glDeleteShader(fsId);
+		return 0;
+	}
+
+	GLuint program = glCreateProgram();
+	glAttachShader(program, vsId);
+	glAttachShader(program, fsId);
+	glLinkProgram(program);
+	glDeleteShader(vsId);
+	glDeleteShader(fsId);
+
+	int linkStatus;
+	glGetProgramiv(program, GL_LINK_STATUS, &linkStatus);
+	if (linkStatus == GL_FALSE)
+	{
+		glGetProgramInfoLog(program, MAX_LENGTH, &logLength, log);
+		std::cout << "===== " << name << " Program Log =====\n" << log << std::endl;
+		glDeleteProgram(program);
+		return 0;
+	}
+
+	// shared light and material buffers
+	GLuint lightBlock = glGetUniformBlockIndex(program, "Light");
+	if (lightBlock != GL_INVALID_INDEX)
+		glUniformBlockBinding(program, lightBlock, LIGHT_BLOCK);
+	GLuint materialBlock = glGetUniformBlockIndex(program, "Materials");
+	if (materialBlock != GL_INVALID_INDEX)
+		glUniformBlockBinding(program, materialBlock, MATERIAL_BLOCK);
+	return program;
+}
+
+bool Renderer::initGLSL()
+{
+	progId = createProgram(vsLitSource, litFragmentSource(fsLitSource).c_str(), "Lit");
+	if (progId == 0)
+		return false;
+
+	uniformModelViewMatrix = glGetUniformLocation(progId, "modelViewMatrix");
+	uniformNormalMatrix = glGetUniformLocation(progId, "normalMatrix");
+	uniformProjectionMatrix = glGetUniformLocation(progId, "projectionMatrix");
+	uniformMaterialIndex = glGetUniformLocation(progId, "materialIndex");
+	uniformUseTexture = glGetUniformLocation(progId, "useTexture");
+	uniformTexture = glGetUniformLocation(progId, "texture0");
+
+	glUseProgram(progId);
+	glUniform1i(uniformTexture, 0);
+	glUseProgram(0);
+
+	createSolids();
+	createUniformBuffers();
+
+	glGenVertexArrays(1, &emptyVao);
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// unit cube (side 1) and unit sphere (radius 1), position + normal, indexed
+///////////////////////////////////////////////////////////////////////////////
+void Renderer::createSolids()
+{
+	std::vector<float> vertices;
+	std::vector<unsigned int> indices;
+
+	// cube: four vertices per face so every face gets its own normal
+	static const float faceNormals[6][3] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+	for (int f = 0; f < 6; f++)
+	{
+		Vector3 n(faceNormals[f][0], faceNormals[f][1], faceNormals[f][2]);
+		// two axes in the face plane with s x t = n, so the corners go counterclockwise
+		Vector3 s(faceNormals[f][1], faceNormals[f][2], faceNormals[f][0]);
+		Vector3 t = n.cross(s);
+		unsigned int base = vertices.size() / 6;
+		static const float corners[4][2] = { { -1, -1 }, { 1, -1 }, { 1, 1 }, { -1, 1 } };
+		for (int c = 0; c < 4; c++)
+		{
+			Vector3 p = 0.5f * (n + corners[c][0] * s + corners[c][1] * t);
+			float vertex[6] = { p.x, p.y, p.z, n.x, n.y, n.z };
+			vertices.insert(vertices.end(), vertex, vertex + 6);
+		}
+		unsigned int quad[6] = { base, base + 1, base + 2, base + 2, base + 3, base };
+		indices.insert(indices.end(), quad, quad + 6);
+	}
+	cubeIndexCount = indices.size();
+
+	glGenVertexArrays(1, &cubeVao);
+	glBindVertexArray(cubeVao);
+	glGenBuffers(2, cubeVbos);
+	glBindBuffer(GL_ARRAY_BUFFER, cubeVbos[0]);
+	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+	glVertexAttribPointer(POSITION, 3, GL_FLOAT, GL_FALSE, SOLID_VERTEX_STRIDE, BUFFER_OFFSET(0));
+	glEnableVertexAttribArray(POSITION);
+	glVertexAttribPointer(NORMAL, 3, GL_FLOAT, GL_FALSE, SOLID_VERTEX_STRIDE, BUFFER_OFFSET(3 * sizeof(float)));
+	glEnableVertexAttribArray(NORMAL);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cubeVbos[1]);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+
+	// sphere around the z axis, same layout as DuckMesh::addSphere, one block per level
+	vertices.clear();
+	indices.clear();
+	for (int level = 0; level < MeshLod::LEVELS; level++)
+	{
+		int segments = MeshLod::segments(SPHERE_SEGMENTS, level);
+		unsigned int base = vertices.size() / 6;
+		sphereIndexOffset[level] = indices.size();
+		for (int i = 0; i <= segments; i++)
+		{
+			float phi = M_PI * i / segments;
+			for (int j = 0; j <= segments; j++)
+			{
+				float theta = 2.0f * M_PI * j / segments;
+				float vertex[6] = { sinf(phi) * cosf(theta), sinf(phi) * sinf(theta), cosf(phi), 0, 0, 0 };
+				vertex[3] = vertex[0];
+				vertex[4] = vertex[1];
+				vertex[5] = vertex[2];
+				vertices.insert(vertices.end(), vertex, vertex + 6);
+			}
+		}
+		for (int i = 0; i < segments; i++)
+		{
+			for (int j = 0; j < segments; j++)
+			{
+				unsigned int k1 = base + i * (segments + 1) + j;
+				unsigned int k2 = k1 + segments + 1;
+				unsigned int quad[6] = { k1, k2, k1 + 1, k1 + 1, k2, k2 + 1 };
+				indices.insert(indices.end(), quad, quad + 6);
+			}
+		}
+		sphereIndexCount[level] = indices.size() - sphereIndexOffset[level];
+	}
+
+	glGenVertexArrays(1, &sphereVao);
+	glBindVertexArray(sphereVao);
+	glGenBuffers(2, sphereVbos);
+	glBindBuffer(GL_ARRAY_BUFFER, sphereVbos[0]);
+	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+	glVertexAttribPointer(POSITION, 3, GL_FLOAT, GL_FALSE, SOLID_VERTEX_STRIDE, BUFFER_OFFSET(0));
+	glEnableVertexAttribArray(POSITION);
+	glVertexAttribPointer(NORMAL, 3, GL_FLOAT, GL_FALSE, SOLID_VERTEX_STRIDE, BUFFER_OFFSET(3 * sizeof(float)));
+	glEnableVertexAttribArray(NORMAL);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, sphereVbos[1]);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(GLuint), indices.data(), GL_STATIC_DRAW);
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+void Renderer::setLight(const float position[4], const float ambient[4], const float diffuse[4], const float specular[4])
+{
+	for (int i = 0; i < 4; i++)
+	{
+		lightPosition[i] = position[i];
+		lightAmbient[i] = ambient[i];
+		lightDiffuse[i] = diffuse[i];
+		lightSpecular[i] = specular[i];
+	}
+	lightChanged = true;
+}
+
+std::string Renderer::litFragmentSource(const char* main)
+{
+	std::ostringstream source;
+	source << "#version 330 core\n#define MAX_MATERIALS " << MAX_MATERIALS << "\n" << litPreludeSource << main;
+	return source.str();
+}
+
+int Renderer::addMaterial(const Material& material)
+{
+	// the Materials block has room for MAX_MATERIALS, a new one past that is refused
+	int index = queue.findMaterial(material);
+	if (index >= 0)
+		return index;
+	if (queue.getMaterialCount() >= MAX_MATERIALS)
+	{
+		if (!materialsFull)
+			std::cerr << "more than " << MAX_MATERIALS << " materials, raise Renderer::MAX_MATERIALS (drawing them with material 0)" << std::endl;
+		materialsFull = true;
+		return 0;
+	}
+	return queue.addMaterial(material);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Light block: 4 vec4. Materials block: MAX_MATERIALS x (ambient, diffuse,
+// specular, shininess padded to a vec4), std140 so no offsets need querying.
+// Bound to their binding points once, programs only reference the points.
+///////////////////////////////////////////////////////////////////////////////
+void Renderer::createUniformBuffers()
+{
+	glGenBuffers(1, &lightUbo);
+	glBindBuffer(GL_UNIFORM_BUFFER, lightUbo);
+	glBufferData(GL_UNIFORM_BUFFER, 16 * sizeof(float), NULL, GL_DYNAMIC_DRAW);
+	glBindBufferBase(GL_UNIFORM_BUFFER, LIGHT_BLOCK, lightUbo);
+
+	glGenBuffers(1, &materialUbo);
+	glBindBuffer(GL_UNIFORM_BUFFER, materialUbo);
+	glBufferData(GL_UNIFORM_BUFFER, MAX_MATERIALS * 16 * sizeof(float), NULL, GL_DYNAMIC_DRAW);
+	glBindBufferBase(GL_UNIFORM_BUFFER, MATERIAL_BLOCK, materialUbo);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+	lightChanged = true;
+	uploadedMaterials = 0;
+}
+
+void Renderer::updateUniformBuffers()
+{
+	if (lightUbo == 0) return;
+
+	if (lightChanged)
+	{
+		float light[16];
+		for (int i = 0; i < 4; i++)
+		{
+			light[i] = lightPosition[i];
+			light[4 + i] = lightAmbient[i];
+			light[8 + i] = lightDiffuse[i];
+			light[12 + i] = lightSpecular[i];
+		}
+		glBindBuffer(GL_UNIFORM_BUFFER, lightUbo);
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(light), light);
+		lightChanged = false;
+	}
+
+	// materials are only ever added, send the new ones
+	int count = queue.getMaterialCount();
+	if (count > uploadedMaterials)
+	{
+		std::vector<float> data((count - uploadedMaterials) * 16);
+		for (int m = uploadedMaterials; m < count; m++)
+		{
+			const Material& material = queue.getMaterial(m);
+			float* d = &data[(m - uploadedMaterials) * 16];
+			for (int i = 0; i < 4; i++)
+			{
+				d[i] = material.ambient[i];
+				d[4 + i] = material.diffuse[i];
+				d[8 + i] = material.specular[i];
+				d[12 + i] = 0.0f;
+			}
+			d[12] = material.shininess;
+		}
+		glBindBuffer(GL_UNIFORM_BUFFER, materialUbo);
+		glBufferSubData(GL_UNIFORM_BUFFER, uploadedMaterials * 16 * sizeof(float), data.size() * sizeof(float), data.data());
+		uploadedMaterials = count;
+	}
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+void Renderer::setCamera(const Matrix4& view, const Matrix4& projection)
+{
+	this->view = view;
+	this->projection = projection;
+	model.identity();
+	frustum.set(projection * view);
+}
+
+void Renderer::setViewport(int width, int height)
+{
+	viewportWidth = width;
+	viewportHeight = height;
+}
+
+void Renderer::begin()
+{
+	queue.clear();
+	texture = 0;
+	model.identity();
+}
+
+void Renderer::end()
+{
+	flush();
+	queue.clear();
+}
+
+void Renderer::setMaterial(const float ambient[4], const float diffuse[4], const float specular[4], float shininess)
+{
+	Material m;
+	for (int i = 0; i < 4; i++)
+	{
+		m.ambient[i] = ambient[i];
+		m.diffuse[i] = diffuse[i];
+		m.specular[i] = specular[i];
+	}
+	m.shininess = shininess;
+	material = addMaterial(m);
+}
+
+void Renderer::setTexture(GLuint texture)
+{
+	this->texture = texture;
+}
+
+void Renderer::setModel(const Matrix4& model)
+{
+	this->model = model;
+}
+
+bool Renderer::isVisible(const Vector3& center, float radius)
+{
+	if (frustum.sphereVisible(center, radius))
+		return true;
+	culled++;
+	return false;
+}
+
+bool Renderer::isVisible(const Vector3& boxMin, const Vector3& boxMax, const Matrix4& model)
+{
+	if (frustum.boxVisible(boxMin, boxMax, model))
+		return true;
+	culled++;
+	return false;
+}
+
+void Renderer::drawSolidCube(float size)
+{
+	// glutSolidCube(1) spans -0.5..0.5
+	if (!isVisible(Vector3(-0.5f, -0.5f, -0.5f), Vector3(0.5f, 0.5f, 0.5f), model * Matrix4().scale(size)))
+		return;
+	submit(cubeVao, GL_TRIANGLES, cubeIndexCount, GL_UNSIGNED_INT, 0, model * Matrix4().scale(size));
+}
+
+void Renderer::drawSolidSphere(float radius)
+{
+	Matrix4 sphereModel = model * Matrix4().scale(radius);
+	Vector3 center = sphereModel * Vector3(0, 0, 0);
+	float worldRadius = MeshLod::maxScale(sphereModel);
+	if (!isVisible(center, worldRadius))
+		return;
+
+	// level from how big the sphere ends up on screen
+	int level = 0;
+	if (viewportHeight > 0)
+	{
+		Vector3 eyeCenter = view * center;
+		float screenRadius = MeshLod::screenRadius(projection, viewportHeight, eyeCenter, worldRadius);
+		level = MeshLod::select(screenRadius);
+	}
+	submit(sphereVao, GL_TRIANGLES, sphereIndexCount[level], GL_UNSIGNED_INT,
+		sphereIndexOffset[level] * sizeof(GLuint), sphereModel);
+}
+
+void Renderer::drawIndexed(GLuint vao, GLenum mode, GLsizei count, GLenum indexType)
+{
+	submit(vao, mode, count, indexType, 0, model);
+}
+
+void Renderer::submit(GLuint vao, GLenum mode, GLsizei count, GLenum indexType, GLsizei indexOffset, const Matrix4& model)
+{
+	queue.submit(progId, texture, material, vao, mode, count, indexType, indexOffset, model);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// issue the pass sorted by program/texture/material, each state is only sent
+// when it differs from the previous draw's
+///////////////////////////////////////////////////////////////////////////////
+void Renderer::flush()
+{
+	if (queue.size() == 0) return;
+	queue.sort();
+	updateUniformBuffers();
+
+	const std::vector<RenderQueue::Item>& items = queue.getItems();
+	GLuint boundProgram = 0;
+	GLuint boundTexture = 0;
+	int boundMaterial = -1;
+	for (size_t i = 0; i < items.size(); i++)
+	{
+		const RenderQueue::Item& item = items[i];
+
+		if (i == 0 || item.program != boundProgram)
+		{
+			// per-pass uniforms belong to the program
+			glUseProgram(item.program);
+			glUniformMatrix4fv(uniformProjectionMatrix, 1, GL_FALSE, projection.get());
+			boundProgram = item.program;
+			boundMaterial = -1;
+			stateChanges++;
+		}
+		else
+			stateChangesAvoided++;
+
+		if (i == 0 || item.texture != boundTexture)
+		{
+			glActiveTexture(GL_TEXTURE0);
+			glBindTexture(GL_TEXTURE_2D, item.texture);
+			glUniform1i(uniformUseTexture, item.texture != 0 ? 1 : 0);
+			boundTexture = item.texture;
+			stateChanges++;
+		}
+		else
+			stateChangesAvoided++;
+
+		if (item.material != boundMaterial)
+		{
+			glUniform1i(uniformMaterialIndex, item.material);
+			boundMaterial = item.material;
+			stateChanges++;
+		}
+		else
+			stateChangesAvoided++;
+
+		Matrix4 modelView = view * item.model;
+		Matrix4 normalMatrix = modelView;
+		normalMatrix.invert().transpose();
+		glUniformMatrix4fv(uniformModelViewMatrix, 1, GL_FALSE, modelView.get());
+		glUniformMatrix4fv(uniformNormalMatrix, 1, GL_FALSE, normalMatrix.get());
+
+		glBindVertexArray(item.vao);
+		glDrawElements(item.mode, item.count, item.indexType, BUFFER_OFFSET((size_t)item.indexOffset));
+		drawCalls++;
+		if (item.mode == GL_TRIANGLES)
+			triangles += item.count / 3;
+	}
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glBindVertexArray(0);
+	glUseProgram(0);
+}
+
+void Renderer::drawPoint()
+{
+	glBindVertexArray(emptyVao);
+	glDrawArrays(GL_POINTS, 0, 1);
+	countDraw(0);
+}
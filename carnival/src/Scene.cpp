@@ -0,0 +1,377 @@
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <ctime>
+#include <cmath>
+
+#define GLEW_STATIC
+#include <GL/glew.h>
+#ifdef _WIN32
+#include <GL/wglew.h> // For wglSwapInterval
+#endif
+
+#define FREEGLUT_STATIC
+#include <GL/freeglut.h>
+
+#include "Vectors.h"
+#include "Matrices.h"
+#include "MatrixStack.h"
+#include "Renderer.h"
+#include "CubeMesh.h"
+#include "QuadMesh.h"
+#include "DuckMesh.h"
+#include "DuckSystem.h"
+#include "DuckBatch.h"
+#include "Gun.h"
+#include "Simulation.h"
+#include "FrameProfiler.h"
+#include "Scene.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// water wave phase, radians per second of simulation
+static const double WAVE_SPEED = 2.0;
+
+// Laser point vertex shader and fragment shader
+// Vertex Shader source for laser point, the point itself is made here (no vertex buffer)
+static const char* vsLaserSource = R"(
+// GLSL version
+#version 330 core
+
+uniform mat4 modelViewProjectionMatrix;
+
+void main(void) {
+    gl_Position = modelViewProjectionMatrix * vec4(0.0, 0.0, 0.0, 1.0);
+    gl_PointSize = 12.0;
+}
+)";
+
+// Fragment Shader source for laser point, round like GL_POINT_SMOOTH made it
+static const char* fsLaserSource = R"(
+// GLSL version
+#version 330 core
+
+out vec4 fragColor;
+
+void main(void) {
+    if (length(gl_PointCoord - vec2(0.5)) > 0.5)
+        discard;
+    fragColor = vec4(0.0, 1.0, 0.0, 1.0);
+}
+)";
+
+// Skybox shaders, the cube's own positions are the cube map directions.
+// z = w puts every sky fragment on the far plane, so with GL_LEQUAL the sky drawn last
+// only fills the pixels nothing else covered.
+static const char* vsSkyboxSource = R"(
+// GLSL version
+#version 330 core
+
+layout(location = 0) in vec3 vertexPosition;
+
+uniform mat4 viewProjectionMatrix;
+
+out vec3 texCoord;
+
+void main(void) {
+    vec4 clipPosition = viewProjectionMatrix * vec4(vertexPosition, 1.0);
+    gl_Position = clipPosition.xyww;
+    texCoord = vertexPosition;
+}
+)";
+
+static const char* fsSkyboxSource = R"(
+// GLSL version
+#version 330 core
+
+in vec3 texCoord;
+
+uniform samplerCube skybox;
+
+out vec4 fragColor;
+
+void main(void) {
+    fragColor = texture(skybox, texCoord);
+}
+)";
+
+// passes are only timed when there is a profiler
+static void beginPass(FrameProfiler* profiler, FrameProfiler::Pass pass)
+{
+	if (profiler)
+		profiler->begin(pass);
+}
+
+static void endPass(FrameProfiler* profiler)
+{
+	if (profiler)
+		profiler->end();
+}
+
+Scene::Scene(int meshSize, int waveSegments)
+{
+	// Set up ground quad mesh
+	Vector3 origin = Vector3(-32.0f, -9.0f, 48.0f);
+	Vector3 dir1v = Vector3(1.0f, 0.0f, 0.0f);
+	Vector3 dir2v = Vector3(0.0f, 0.0f, -1.0f);
+	ground = new QuadMesh(meshSize, 64.0);
+	ground->InitMesh(meshSize, origin, 64.0, 64.0, dir1v, dir2v);
+
+	Vector3 ambient = Vector3(0.0f, 1.0f, 0.0f);
+	Vector3 diffuse = Vector3(0.0f, 0.8f, 0.0f);
+	Vector3 specular = Vector3(0.04f, 0.04f, 0.04f);
+	float shininess = 0.2;
+	ground->SetMaterial(ambient, diffuse, specular, shininess);
+
+	boothTop = new CubeMesh();
+	ambient = Vector3(0.2f, 0.00f, 0.0f);
+	diffuse = Vector3(0.9f, 0.9f, 0.9f);
+	specular = Vector3(0.5f, 0.5f, 0.5f);
+	shininess = 4.0;
+	boothTop->setMaterial(ambient, diffuse, specular, shininess);
+
+	boothFront = new CubeMesh();
+	boothFront->setMaterial(ambient, diffuse, specular, shininess);
+
+	boothLeftSide = new CubeMesh();
+	ambient = Vector3(0.2f, 0.2f, 0.2f);
+	diffuse = Vector3(0.7f, 0.7f, 0.7f);
+	specular = Vector3(1.0f, 1.0f, 1.0f);
+	shininess = 4.0;
+	boothLeftSide->setMaterial(ambient, diffuse, specular, shininess);
+
+	boothRightSide = new CubeMesh();
+	boothRightSide->setMaterial(ambient, diffuse, specular, shininess);
+	drawBoothFront = true;
+
+	water = SineWaveMesh();
+	this->waveSegments = waveSegments;
+	duckMesh = NULL;
+	duckBatch = NULL;
+
+	textures = Textures();
+	laserProgram = 0;
+	skyboxProgram = 0;
+	uniformSkyboxViewProjection = -1;
+	skyboxVao = 0;
+	skyboxVbos[0] = skyboxVbos[1] = 0;
+}
+
+Scene::~Scene()
+{
+	release();
+	delete ground;
+	delete boothTop;
+	delete boothLeftSide;
+	delete boothRightSide;
+	delete boothFront;
+}
+
+bool Scene::initGLSL(Renderer& renderer)
+{
+	bool ok = true;
+
+	// program for laser
+	laserProgram = Renderer::createProgram(vsLaserSource, fsLaserSource, "Pointer Laser");
+
+	// program for skybox
+	skyboxProgram = Renderer::createProgram(vsSkyboxSource, fsSkyboxSource, "Skybox");
+	if (skyboxProgram != 0)
+	{
+		glUseProgram(skyboxProgram);
+		uniformSkyboxViewProjection = glGetUniformLocation(skyboxProgram, "viewProjectionMatrix");
+		glUniform1i(glGetUniformLocation(skyboxProgram, "skybox"), 0);
+		glUseProgram(0);
+		createSkybox();
+	}
+	ok = laserProgram != 0 && skyboxProgram != 0;
+
+	// ground grid goes to the GPU once
+	ground->CreateMeshVBO();
+
+	// water wall is built once, the waves move in its vertex shader
+	if (!createSineWaveMesh(water, renderer, waveSegments))
+		ok = false;
+
+	// build duck geometry once and share it between all ducks
+	duckMesh = new DuckMesh();
+	duckMesh->CreateMeshVBO();
+
+	// all ducks are drawn together with instancing
+	duckBatch = new DuckBatch(duckMesh);
+	if (!duckBatch->initGLSL(renderer))
+	{
+		delete duckBatch;
+		duckBatch = NULL;
+	}
+	return ok;
+}
+
+void Scene::release()
+{
+	delete duckBatch;
+	duckBatch = NULL;
+	delete duckMesh;
+	duckMesh = NULL;
+	deleteSineWaveMesh(water);
+	deleteSineWaveProgram();
+	if (skyboxVao)
+	{
+		glDeleteBuffers(2, skyboxVbos);
+		glDeleteVertexArrays(1, &skyboxVao);
+		skyboxVao = 0;
+	}
+	if (laserProgram)
+		glDeleteProgram(laserProgram);
+	if (skyboxProgram)
+		glDeleteProgram(skyboxProgram);
+	laserProgram = skyboxProgram = 0;
+}
+
+// skybox cube, built once. Triangles wind counterclockwise seen from inside,
+// so it is drawn with the usual back face culling
+void Scene::createSkybox()
+{
+	static const GLfloat corners[8][3] = {
+		{ -1, -1, -1 }, { 1, -1, -1 }, { 1, 1, -1 }, { -1, 1, -1 },
+		{ -1, -1, 1 }, { 1, -1, 1 }, { 1, 1, 1 }, { -1, 1, 1 } };
+	static const GLubyte indices[36] = {
+		1, 5, 6, 6, 2, 1,   // +x
+		4, 0, 3, 3, 7, 4,   // -x
+		3, 2, 6, 6, 7, 3,   // +y
+		4, 5, 1, 1, 0, 4,   // -y
+		4, 7, 6, 6, 5, 4,   // +z
+		1, 2, 3, 3, 0, 1 }; // -z
+
+	glGenVertexArrays(1, &skyboxVao);
+	glBindVertexArray(skyboxVao);
+	glGenBuffers(2, skyboxVbos);
+	glBindBuffer(GL_ARRAY_BUFFER, skyboxVbos[0]);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+	glEnableVertexAttribArray(0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, skyboxVbos[1]);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+// cube around the camera, the view is given without translation.
+// Drawn after the scene: it lands on the far plane and the depth test (GL_LEQUAL) skips covered pixels
+void Scene::drawSkybox(Renderer& renderer, const Matrix4& view)
+{
+	if (skyboxProgram == 0 || skyboxVao == 0) return;
+
+	glUseProgram(skyboxProgram);
+	Matrix4 viewProjection = renderer.getProjection() * view;
+	glUniformMatrix4fv(uniformSkyboxViewProjection, 1, GL_FALSE, viewProjection.get());
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_CUBE_MAP, textures.skybox);
+
+	glBindVertexArray(skyboxVao);
+	glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_BYTE, (void*)0);
+	glBindVertexArray(0);
+	renderer.countDraw(12);
+
+	glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+	glUseProgram(0);
+}
+
+void Scene::draw(Renderer& renderer, Simulation& simulation, const Matrix4& view, const Matrix4& skyView,
+				 const Matrix4& projection, float alpha, FrameProfiler* profiler)
+{
+	renderer.resetStats();
+	// light and material buffers shared by every lit program of the frame
+	renderer.updateUniformBuffers();
+
+	// ground uses the sky's view as well (it stays put under the camera)
+	beginPass(profiler, FrameProfiler::GROUND);
+	renderer.setCamera(skyView, projection);
+	renderer.begin();
+	renderer.setTexture(textures.ground); // texture for ground mesh (repeat it)
+	ground->DrawMesh(renderer);
+	renderer.setTexture(0); // reset textures
+	renderer.end();
+	endPass(profiler);
+
+	renderer.setCamera(view, projection);
+
+	// ducks and bullets are drawn between the last two simulation ticks,
+	// one instanced draw per duck part, independent of the duck count
+	DuckSystem& ducks = simulation.getDucks();
+	ducks.interpolate(alpha);
+	beginPass(profiler, FrameProfiler::DUCKS);
+	if (duckBatch)
+		duckBatch->draw(ducks, renderer);
+	endPass(profiler);
+
+	// gun and booth share one sorted pass
+	beginPass(profiler, FrameProfiler::GUN_BOOTH);
+	renderer.begin();
+	simulation.getGun().draw(renderer, alpha);
+
+	MatrixStack model;
+	renderer.setTexture(textures.boothTop); // texture for booth top
+	model.push();
+	model.translate(0, 12.0f, -8.0);
+	model.scale(16.0f, 2.0f, 2.0f);
+	boothTop->drawCubeMesh(renderer, model.top());
+	model.pop();
+
+	renderer.setTexture(textures.boothSide); // texture for booth sides
+	model.push();
+	model.translate(-14.0, 0.0f, -8.0);
+	model.scale(1.0f, 10.0f, 2.0f);
+	boothLeftSide->drawCubeMesh(renderer, model.top());
+	model.pop();
+
+	model.push();
+	model.translate(14.0, 0.0f, -8.0);
+	model.scale(1.0f, 10.0f, 2.0f);
+	boothRightSide->drawCubeMesh(renderer, model.top());
+	model.pop();
+
+	if (drawBoothFront)
+	{
+		renderer.setTexture(textures.boothFront); // texture for booth front
+		model.push();
+		model.translate(0, -6.0, -6.0);
+		model.scale(12.0f, 4.0f, 0.5f);
+		boothFront->drawCubeMesh(renderer, model.top());
+		model.pop();
+	}
+
+	renderer.setTexture(0); // reset textures
+	renderer.end();
+	endPass(profiler);
+
+	// water waves with sine wave function, animated in the vertex shader
+	beginPass(profiler, FrameProfiler::WATER);
+	double waveTime = (simulation.getTicks() + alpha) * simulation.getTickSeconds();
+	float wavePhase = (float)fmod(waveTime * WAVE_SPEED, 2.0 * M_PI);
+	model.push();
+	model.translate(0.0, -6.0, -14.0);
+	model.rotate(-180, 0, 1, 0);
+	drawSineWaveMesh(water, renderer, model.top(), wavePhase);
+	model.pop();
+	endPass(profiler);
+
+	// sky last, only where the scene left the far plane
+	beginPass(profiler, FrameProfiler::SKYBOX);
+	drawSkybox(renderer, skyView);
+	endPass(profiler);
+
+	beginPass(profiler, FrameProfiler::LASER);
+	simulation.getGun().drawLaser(renderer, laserProgram);
+	endPass(profiler);
+}
+
+int Scene::getDucksCulled()
+{
+	return duckBatch ? duckBatch->getCulled() : 0;
+}
@@ -0,0 +1,47 @@
+#include <chrono>
+
+#include "SimClock.h"
+
+SimClock::SimClock(double tickSeconds, int maxTicksPerFrame)
+{
+	this->tickSeconds = tickSeconds;
+	this->maxTicksPerFrame = maxTicksPerFrame;
+	reset();
+}
+
+void SimClock::reset()
+{
+	accumulator = 0.0;
+	lastTime = 0.0;
+	started = false;
+	tick = 0;
+}
+
+double SimClock::now()
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int SimClock::advance()
+{
+	double time = now();
+	// first frame only starts the clock
+	double elapsed = started ? time - lastTime : 0.0;
+	lastTime = time;
+	started = true;
+	return advance(elapsed);
+}
+
+int SimClock::advance(double elapsedSeconds)
+{
+	accumulator += elapsedSeconds;
+	int ticks = (int)(accumulator / tickSeconds);
+	accumulator -= ticks * tickSeconds;
+
+	if (ticks > maxTicksPerFrame)
+	{
+		// too far behind (debugger, window drag), drop the rest
+		ticks = maxTicksPerFrame;
+	}
+	return ticks;
+}
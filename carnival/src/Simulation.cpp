@@ -0,0 +1,95 @@
+#include <vector>
+
+#include "Vectors.h"
+#include "Matrices.h"
+#include "Simulation.h"
+
+Simulation::Simulation(double tickSeconds, int maxBullets) : gun(maxBullets)
+{
+	this->tickSeconds = tickSeconds;
+}
+
+void Simulation::setupGallery(int lanes, float laneSpacing)
+{
+	lanes = lanes < 1 ? 1 : (lanes > MAX_LANES ? MAX_LANES : lanes);
+	ducks.clear();
+	ducks.reserve(6 * lanes);
+	for (int lane = 0; lane < lanes; lane++)
+	{
+		float z = -8.0f - lane * laneSpacing;
+
+		// on wave, x coordinates -8.0f, 0.0f and 8.0f
+		ducks.addDuck(-8.0f, false, z);
+		ducks.addDuck(0.f, false, z);
+		ducks.addDuck(8.0f, false, z);
+
+		// below wave, x coordinate is same as ducks above but flipped 
+		ducks.addDuck(8.0f, true, z);
+		ducks.addDuck(0.f, true, z);
+		ducks.addDuck(-8.0f, true, z);
+	}
+	hitCandidates.reserve(ducks.size());
+	tickHitDucks.reserve(ducks.size());
+}
+
+bool Simulation::shoot()
+{
+	if (!gun.shoot())
+		return false;
+	shotsFired++;
+	return true;
+}
+
+void Simulation::tick()
+{
+	tickHitDucks.clear();
+
+	// start of this tick is what frames interpolate from
+	ducks.savePrevious();
+	if (moving)
+	{
+		// animate all ducks around track in one pass, scaled from their 12 ms step to the tick
+		ducks.animate(true, (float)(tickSeconds / DuckSystem::getStepSeconds()));
+	}
+
+	updateBullets();
+
+	totalHits += tickHitDucks.size();
+	ticks++;
+}
+
+void Simulation::updateBullets()
+{
+	if (!gun.isInMotion())
+		return;
+
+	// move all bullets (animate), finished ones are recycled
+	gun.moveBullets();
+	if (!gun.isInMotion())
+		return;
+
+	// bullseye positions in world space once for all bullets
+	ducks.updateTargetCoords();
+	targetGrid.build(ducks);
+
+	// test the whole path every bullet travelled this step, so fast bullets
+	// cannot skip over a duck between two ticks
+	for (int b = 0; b < gun.getBulletCount(); b++)
+	{
+		Vector3 bulletFrom, bulletTo;
+		gun.getBulletPath(b, bulletFrom, bulletTo);
+
+		// check if bullet hits any of the ducks near its path and flip them if they do
+		hitCandidates.clear();
+		targetGrid.query(bulletFrom, bulletTo, ducks.getTargetRadius(), DuckSystem::getTargetDepth(), hitCandidates);
+		for (size_t k = 0; k < hitCandidates.size(); k++)
+		{
+			int duck = hitCandidates[k];
+			if (ducks.hit(duck, bulletFrom, bulletTo))
+			{
+				ducks.flip(duck);
+				tickHitDucks.push_back(duck);
+			}
+		}
+	}
+}
@@ -1,10 +1,9 @@
-﻿// This code was generated by chatGPT
-
-#include <string>
+﻿#include <string>
 #include <iostream>
 #include <fstream>
 #include <vector>
 #include <ctime>
+#include <cmath>
 
 #define GLEW_STATIC
 #include <GL/glew.h>
@@ -21,8 +20,12 @@
 #include <glm/gtx/transform.hpp>
 #include <glm/gtx/quaternion.hpp>
 
+#include "Matrices.h"
+#include "Renderer.h"
 #include "SineWaveStrip.h"
 
+#define BUFFER_OFFSET(offset) ((void*)(offset))
+
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
@@ -32,22 +35,21 @@
 
 Curve: edit Y0, AMP, FREQ.
 
-Smoothness: increase SEG.
+Smoothness: pass more segments to createSineWaveMesh().
 
 Thickness in Z: change Z_HALF (total thickness = 2*Z_HALF).
 */
 static const float XMIN = -12.0f;
 static const float XMAX = 12.0f;
-static const int   SEG = 400;      // longitudinal subdivisions
 
 static const float Y_BASE = 3.0f;   // baseline (bottom of the wall)
 // ---------- Curve + Mesh Parameters ----------
 
 
-// y(x) = Y0 + AMP * sin(FREQ * x), centered at 5.0 as requested
+// y(x) = Y0 + AMP * sin(FREQ * (x - XMIN) - pi/2 + phase), centered at 5.0 as requested
 static const float Y0 = 5.0f;
 static const float AMP = 1.0f;
-static const float FREQ = 1.0f;
+static const float FREQ = (float)(M_PI / 2.0);
 
 // -------- Extrusion in Z --------
 static const float Z_CENTER = -6.0f;     // wall center in Z
@@ -55,102 +57,285 @@ static const float Z_THICK = 0.5f;      // total thickness
 static const float Z_FRONT = (Z_CENTER + 0.5f * Z_THICK); // closer to viewer
 static const float Z_BACK = (Z_CENTER - 0.5f * Z_THICK); // farther from viewer
 
-
-static void v3(float r[3], float x, float y, float z) { r[0] = x; r[1] = y; r[2] = z; }
-static float vlen(const float a[3]) { return sqrtf(a[0] * a[0] + a[1] * a[1] + a[2] * a[2]); }
-static void vnorm(float r[3], const float a[3]) { float L = vlen(a); if (L > 1e-12f) { r[0] = a[0] / L; r[1] = a[1] / L; r[2] = a[2] / L; } else v3(r, 0, 0, 1); }
-
-
-static const int   SEGMENTS = 200;    // longitudinal subdivisions
+// -------- Vertex kinds (w of the position) --------
+static const float ON_BASE = 0.0f;     // stays at Y_BASE
+static const float ON_CURVE = 1.0f;    // y follows the wave
+static const float ON_RIM = 2.0f;      // y follows the wave, normal from the slope
 
 static GLfloat ambient[] = { 0.137f, 0.298f, 0.369f, 1.0f };
 static GLfloat diffuse[] = { 0.137f, 0.298, 0.369f, 1.0f };
 static GLfloat specular[] = { 0.5f, 0.5f, 0.5f, 1.0f };
 static GLfloat shininess[] = { 4.0F };
 
-//Sample curve and derivative
+//Sample curve (the vertex shader evaluates the same curve every frame)
+
+static inline float y_of_x(float x, float phase) { return Y0 + AMP * sinf(FREQ * (x - XMIN) - (float)(M_PI / 2.0) + phase); }
+
+
+// Vertex shader: lifts the curve vertices onto the wave for this frame's phase
+const char* vsSineWaveSource = R"(
+#version 330 core
+
+layout(location = 0) in vec4 vertexPosition;        // w: 0 base, 1 curve, 2 curve with slope normal
+layout(location = 1) in vec3 vertexNormal;
+
+uniform mat4 modelViewMatrix;
+uniform mat4 normalMatrix;
+uniform mat4 projectionMatrix;
+uniform vec4 wave;                                  // x0, y0, amplitude, frequency
+uniform float phase;
+
+out vec3 position;
+out vec3 normal;
+
+void main(void)
+{
+    vec3 p = vertexPosition.xyz;
+    vec3 n = vertexNormal;
+    if (vertexPosition.w > 0.5)
+    {
+        float angle = wave.w * (p.x - wave.x) - 1.57079633 + phase;
+        p.y = wave.y + wave.z * sin(angle);
+        if (vertexPosition.w > 1.5)
+        {
+            // outward normal in XY plane: (-dy/dx, 1, 0)
+            n = normalize(vec3(-wave.z * wave.w * cos(angle), 1.0, 0.0));
+        }
+    }
+
+    vec4 eyePosition = modelViewMatrix * vec4(p, 1.0);
+    gl_Position = projectionMatrix * eyePosition;
+    position = eyePosition.xyz;
+    normal = normalize(mat3(normalMatrix) * n);
+}
+)";
+
+// Fragment shader: same light 0 and material as the Renderer's lit program
+// (Renderer::litFragmentSource() puts the lighting in front)
+const char* fsSineWaveSource = R"(
+in vec3 position;
+in vec3 normal;
+
+out vec4 fragColor;
+
+void main()
+{
+    MaterialData material = materials[materialIndex];
+    fragColor = vec4(blinnPhong(material, position, normal), material.diffuse.a);
+}
+)";
+
+// one program for the water, shared by every SineWaveMesh
+static GLuint waveProgram = 0;
+static GLint uniformModelViewMatrix;
+static GLint uniformNormalMatrix;
+static GLint uniformProjectionMatrix;
+static GLint uniformWave;
+static GLint uniformPhase;
+static GLint uniformMaterialIndex;
+
+static bool createWaveProgram()
+{
+    if (waveProgram)
+        return true;
+
+    waveProgram = Renderer::createProgram(vsSineWaveSource, Renderer::litFragmentSource(fsSineWaveSource).c_str(), "Sine Wave");
+    if (waveProgram == 0)
+        return false;
+
+    uniformModelViewMatrix = glGetUniformLocation(waveProgram, "modelViewMatrix");
+    uniformNormalMatrix = glGetUniformLocation(waveProgram, "normalMatrix");
+    uniformProjectionMatrix = glGetUniformLocation(waveProgram, "projectionMatrix");
+    uniformWave = glGetUniformLocation(waveProgram, "wave");
+    uniformPhase = glGetUniformLocation(waveProgram, "phase");
+    uniformMaterialIndex = glGetUniformLocation(waveProgram, "materialIndex");
+    return true;
+}
+
+// vertices and triangles of the wall, filled by createSineWaveMesh()
+static std::vector<float> wavePositions;
+static std::vector<float> waveNormals;
+static std::vector<unsigned int> waveIndices;
 
-static inline float y_of_x(float x) { return Y0 + AMP * sinf((3.14159265 / 2.0 * (x - XMIN))+ -(3.14159265 / 2.0)); }
-static inline float dydx_of_x(float x) { return AMP * FREQ * cosf(FREQ * x); }
+static void addVertex(float x, float y, float z, float kind, float nx, float ny, float nz)
+{
+    float p[4] = { x, y, z, kind };
+    float n[3] = { nx, ny, nz };
+    wavePositions.insert(wavePositions.end(), p, p + 4);
+    waveNormals.insert(waveNormals.end(), n, n + 3);
+}
 
+// triangles of a strip of segments+1 vertex pairs added from 'first' on (same winding as GL_TRIANGLE_STRIP)
+static void addStrip(unsigned int first, int segments)
+{
+    for (int i = 0; i < segments; i++) {
+        unsigned int a = first + 2 * i;
+        unsigned int b = a + 2;
+        unsigned int tri[6] = { a, a + 1, b, b, a + 1, b + 1 };
+        waveIndices.insert(waveIndices.end(), tri, tri + 6);
+    }
+}
 
-static float zoom = 1.0f;
-static float zrot = 0.0f;
+// triangles of a 4 vertex fan added from 'first' on
+static void addFan(unsigned int first)
+{
+    unsigned int tri[6] = { first, first + 1, first + 2, first, first + 2, first + 3 };
+    waveIndices.insert(waveIndices.end(), tri, tri + 6);
+}
 
+static unsigned int vertexCount()
+{
+    return (unsigned int)(wavePositions.size() / 4);
+}
 
-void drawSineWaveMesh(void)
+bool createSineWaveMesh(SineWaveMesh& mesh, Renderer& renderer, int segments)
 {
-    glMaterialfv(GL_FRONT, GL_AMBIENT, ambient);
-    glMaterialfv(GL_FRONT, GL_SPECULAR, specular);
-    glMaterialfv(GL_FRONT, GL_DIFFUSE, diffuse);
-    glMaterialfv(GL_FRONT, GL_SHININESS, shininess);
+    if (!createWaveProgram())
+        return false;
+
+    Material material;
+    for (int i = 0; i < 4; i++) {
+        material.ambient[i] = ambient[i];
+        material.diffuse[i] = diffuse[i];
+        material.specular[i] = specular[i];
+    }
+    material.shininess = shininess[0];
+    mesh.material = renderer.addMaterial(material);
+
+    wavePositions.clear();
+    waveNormals.clear();
+    waveIndices.clear();
 
-    float dx = (XMAX - XMIN) / SEG;
+    float dx = (XMAX - XMIN) / segments;
+    unsigned int first;
 
     // ----- FRONT FACE -----
-    glNormal3f(0,0,1);
-    glBegin(GL_TRIANGLE_STRIP);
-    for(int i=0;i<=SEG;i++){
+    first = vertexCount();
+    for(int i=0;i<=segments;i++){
         float x = XMIN + i*dx;
-        glVertex3f(x, Y_BASE, Z_FRONT);
-        glVertex3f(x, y_of_x(x), Z_FRONT);
+        addVertex(x, Y_BASE, Z_FRONT, ON_BASE, 0, 0, 1);
+        addVertex(x, y_of_x(x, 0.0f), Z_FRONT, ON_CURVE, 0, 0, 1);
     }
-    glEnd();
+    addStrip(first, segments);
 
     // ----- BACK FACE -----
-    glNormal3f(0,0,-1);
-    glBegin(GL_TRIANGLE_STRIP);
-    for(int i=0;i<=SEG;i++){
+    first = vertexCount();
+    for(int i=0;i<=segments;i++){
         float x = XMIN + i*dx;
-        glVertex3f(x, Y_BASE, Z_BACK);
-        glVertex3f(x, y_of_x(x), Z_BACK);
+        addVertex(x, Y_BASE, Z_BACK, ON_BASE, 0, 0, -1);
+        addVertex(x, y_of_x(x, 0.0f), Z_BACK, ON_CURVE, 0, 0, -1);
     }
-    glEnd();
+    addStrip(first, segments);
 
-    // ----- TOP RIM -----
-    glBegin(GL_TRIANGLE_STRIP);
-    for(int i=0;i<=SEG;i++){
+    // ----- TOP RIM (normal comes from the slope in the shader) -----
+    first = vertexCount();
+    for(int i=0;i<=segments;i++){
         float x = XMIN + i*dx;
-        float y = y_of_x(x);
-        float dy = dydx_of_x(x);
-        // outward normal in XY plane: (-dy/dx, 1, 0)
-        float nx = -dy, ny = 1.0f;
-        float len = sqrtf(nx*nx + ny*ny);
-        nx/=len; ny/=len;
-        glNormal3f(nx,ny,0);
-        glVertex3f(x, y, Z_FRONT);
-        glVertex3f(x, y, Z_BACK);
+        float y = y_of_x(x, 0.0f);
+        addVertex(x, y, Z_FRONT, ON_RIM, 0, 1, 0);
+        addVertex(x, y, Z_BACK, ON_RIM, 0, 1, 0);
     }
-    glEnd();
+    addStrip(first, segments);
 
-    // ----- BASE RIM (y=4) -----
-    glNormal3f(0,-1,0);
-    glBegin(GL_TRIANGLE_STRIP);
-    for(int i=0;i<=SEG;i++){
+    // ----- BASE RIM (y=Y_BASE) -----
+    first = vertexCount();
+    for(int i=0;i<=segments;i++){
         float x = XMIN + i*dx;
-        glVertex3f(x, Y_BASE, Z_FRONT);
-        glVertex3f(x, Y_BASE, Z_BACK);
+        addVertex(x, Y_BASE, Z_FRONT, ON_BASE, 0, -1, 0);
+        addVertex(x, Y_BASE, Z_BACK, ON_BASE, 0, -1, 0);
     }
-    glEnd();
+    addStrip(first, segments);
 
     // ----- LEFT CAP (x = XMIN) -----
-    glNormal3f(-1,0,0);
-    glBegin(GL_QUADS);
-    glVertex3f(XMIN, Y_BASE, Z_FRONT);
-    glVertex3f(XMIN, y_of_x(XMIN), Z_FRONT);
-    glVertex3f(XMIN, y_of_x(XMIN), Z_BACK);
-    glVertex3f(XMIN, Y_BASE, Z_BACK);
-    glEnd();
+    first = vertexCount();
+    addVertex(XMIN, Y_BASE, Z_FRONT, ON_BASE, -1, 0, 0);
+    addVertex(XMIN, y_of_x(XMIN, 0.0f), Z_FRONT, ON_CURVE, -1, 0, 0);
+    addVertex(XMIN, y_of_x(XMIN, 0.0f), Z_BACK, ON_CURVE, -1, 0, 0);
+    addVertex(XMIN, Y_BASE, Z_BACK, ON_BASE, -1, 0, 0);
+    addFan(first);
 
     // ----- RIGHT CAP (x = XMAX) -----
-    glNormal3f(1,0,0);
-    glBegin(GL_QUADS);
-    glVertex3f(XMAX, Y_BASE, Z_FRONT);
-    glVertex3f(XMAX, y_of_x(XMAX), Z_FRONT);
-    glVertex3f(XMAX, y_of_x(XMAX), Z_BACK);
-    glVertex3f(XMAX, Y_BASE, Z_BACK);
-    glEnd();
+    first = vertexCount();
+    addVertex(XMAX, Y_BASE, Z_FRONT, ON_BASE, 1, 0, 0);
+    addVertex(XMAX, y_of_x(XMAX, 0.0f), Z_FRONT, ON_CURVE, 1, 0, 0);
+    addVertex(XMAX, y_of_x(XMAX, 0.0f), Z_BACK, ON_CURVE, 1, 0, 0);
+    addVertex(XMAX, Y_BASE, Z_BACK, ON_BASE, 1, 0, 0);
+    addFan(first);
+
+    mesh.indexCount = (GLsizei)waveIndices.size();
+
+    glGenVertexArrays(1, &mesh.vao);
+    glBindVertexArray(mesh.vao);
+    glGenBuffers(1, &mesh.vbo_pos);
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo_pos);
+    glBufferData(GL_ARRAY_BUFFER, wavePositions.size() * sizeof(float), wavePositions.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(Renderer::POSITION, 4, GL_FLOAT, GL_FALSE, 0, BUFFER_OFFSET(0));
+    glEnableVertexAttribArray(Renderer::POSITION);
+    glGenBuffers(1, &mesh.vbo_nrm);
+    glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo_nrm);
+    glBufferData(GL_ARRAY_BUFFER, waveNormals.size() * sizeof(float), waveNormals.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(Renderer::NORMAL, 3, GL_FLOAT, GL_FALSE, 0, BUFFER_OFFSET(0));
+    glEnableVertexAttribArray(Renderer::NORMAL);
+    glGenBuffers(1, &mesh.ebo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, waveIndices.size() * sizeof(unsigned int), waveIndices.data(), GL_STATIC_DRAW);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    // the GPU has its own copy now
+    std::vector<float>().swap(wavePositions);
+    std::vector<float>().swap(waveNormals);
+    std::vector<unsigned int>().swap(waveIndices);
+    return true;
 }
 
+void deleteSineWaveMesh(SineWaveMesh& mesh)
+{
+    if (mesh.vao)
+    {
+        GLuint buffers[3] = { mesh.vbo_pos, mesh.vbo_nrm, mesh.ebo };
+        glDeleteBuffers(3, buffers);
+        glDeleteVertexArrays(1, &mesh.vao);
+    }
+    mesh.vao = mesh.vbo_pos = mesh.vbo_nrm = mesh.ebo = 0;
+    mesh.indexCount = 0;
+}
 
+void deleteSineWaveProgram()
+{
+    if (waveProgram)
+        glDeleteProgram(waveProgram);
+    waveProgram = 0;
+}
 
+void drawSineWaveMesh(const SineWaveMesh& mesh, Renderer& renderer, const Matrix4& model, float phase)
+{
+    if (mesh.vao == 0)
+        return;
+
+    // the wall at any phase: base up to the crest, front to back
+    Vector3 boundsMin(XMIN, Y_BASE, Z_BACK);
+    Vector3 boundsMax(XMAX, Y0 + AMP, Z_FRONT);
+    if (!renderer.isVisible(boundsMin, boundsMax, model))
+        return;
+
+    Matrix4 modelView = renderer.getView() * model;
+    Matrix4 normalMatrix = modelView;
+    normalMatrix.invert().transpose();
+
+    glUseProgram(waveProgram);
+    glUniformMatrix4fv(uniformModelViewMatrix, 1, GL_FALSE, modelView.get());
+    glUniformMatrix4fv(uniformNormalMatrix, 1, GL_FALSE, normalMatrix.get());
+    glUniformMatrix4fv(uniformProjectionMatrix, 1, GL_FALSE, renderer.getProjection().get());
+    glUniform4f(uniformWave, XMIN, Y0, AMP, FREQ);
+    glUniform1f(uniformPhase, phase);
+    glUniform1i(uniformMaterialIndex, mesh.material);
+
+    glBindVertexArray(mesh.vao);
+    glDrawElements(GL_TRIANGLES, mesh.indexCount, GL_UNSIGNED_INT, BUFFER_OFFSET(0));
+    glBindVertexArray(0);
+    glUseProgram(0);
+    renderer.countDraw(mesh.indexCount / 3);
+}
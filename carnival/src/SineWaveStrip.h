@@ -1,14 +1,29 @@
 // ---------- Mesh Container ----------
+// Built once by createSineWaveMesh(). Vertex positions are (x, y, z, kind), where kind tells the
+// vertex shader whether the vertex sits on the base, on the curve or on the top rim;
+// the curve is moved by the phase given to drawSineWaveMesh().
 typedef struct {
     GLuint vao;
     GLuint vbo_pos;
     GLuint vbo_nrm;
     GLuint ebo;
     GLsizei indexCount;
-
-    float* positions;
-    float* normals;
+    int material;           // index in the renderer's Materials block
 } SineWaveMesh;
 
 
-void drawSineWaveMesh(void);
+class Renderer;
+
+// subdivisions along the wall the game builds it with, pass more for a smoother wall
+static const int SINE_WAVE_SEGMENTS = 400;
+
+// compile the wave program and upload the wall, needs a current GL context.
+// The water material is added to the renderer's material table.
+bool createSineWaveMesh(SineWaveMesh& mesh, Renderer& renderer, int segments = SINE_WAVE_SEGMENTS);
+void deleteSineWaveMesh(SineWaveMesh& mesh);
+// the program every wall is drawn with, made again by the next createSineWaveMesh()
+void deleteSineWaveProgram();
+
+// one draw with its own program, call outside renderer.begin()/end().
+// Nothing is drawn when the wall is outside the renderer's frustum.
+void drawSineWaveMesh(const SineWaveMesh& mesh, Renderer& renderer, const Matrix4& model, float phase);
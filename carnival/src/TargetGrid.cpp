@@ -0,0 +1,114 @@
+#include <vector>
+#include <cmath>
+
+#include "Vectors.h"
+#include "Matrices.h"
+#include "DuckSystem.h"
+#include "TargetGrid.h"
+
+// keeps a very spread out gallery from allocating a huge grid, cells get coarser instead
+static const int MAX_CELLS_PER_AXIS = 4096;
+
+TargetGrid::TargetGrid(float cellSize)
+{
+	this->cellSize = cellSize;
+	gridCellSize = cellSize;
+	originX = 0.0f;
+	originZ = 0.0f;
+	cellsX = 1;
+	cellsZ = 1;
+}
+
+int TargetGrid::cellX(float x) const
+{
+	int c = (int)floorf((x - originX) / gridCellSize);
+	return c < 0 ? 0 : (c >= cellsX ? cellsX - 1 : c);
+}
+
+int TargetGrid::cellZ(float z) const
+{
+	int c = (int)floorf((z - originZ) / gridCellSize);
+	return c < 0 ? 0 : (c >= cellsZ ? cellsZ - 1 : c);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// counting sort of the ducks by cell: count, prefix sum, scatter
+///////////////////////////////////////////////////////////////////////////////
+void TargetGrid::build(const DuckSystem& ducks)
+{
+	const int count = ducks.size();
+	const float* targetX = ducks.getTargetX();
+	const float* targetZ = ducks.getTargetZ();
+
+	// bounds of the bullseyes this tick
+	float minX = 0.0f, maxX = 0.0f, minZ = 0.0f, maxZ = 0.0f;
+	for (int i = 0; i < count; i++)
+	{
+		if (i == 0 || targetX[i] < minX) minX = targetX[i];
+		if (i == 0 || targetX[i] > maxX) maxX = targetX[i];
+		if (i == 0 || targetZ[i] < minZ) minZ = targetZ[i];
+		if (i == 0 || targetZ[i] > maxZ) maxZ = targetZ[i];
+	}
+
+	float size = cellSize;
+	float extent = (maxX - minX) > (maxZ - minZ) ? (maxX - minX) : (maxZ - minZ);
+	if (extent / size >= MAX_CELLS_PER_AXIS)
+		size = extent / (MAX_CELLS_PER_AXIS - 1);
+	gridCellSize = size;
+	originX = minX;
+	originZ = minZ;
+	cellsX = (int)((maxX - minX) / size) + 1;
+	cellsZ = (int)((maxZ - minZ) / size) + 1;
+
+	const int cells = cellsX * cellsZ;
+	cellStart.assign(cells + 1, 0);
+	cellDucks.resize(count);
+	duckCell.resize(count);
+
+	for (int i = 0; i < count; i++)
+	{
+		int c = cellZ(targetZ[i]) * cellsX + cellX(targetX[i]);
+		duckCell[i] = c;
+		cellStart[c + 1]++;
+	}
+	for (int c = 0; c < cells; c++)
+		cellStart[c + 1] += cellStart[c];
+
+	// cellStart[c] is used as the write cursor, then shifted back
+	for (int i = 0; i < count; i++)
+		cellDucks[cellStart[duckCell[i]]++] = i;
+	for (int c = cells; c > 0; c--)
+		cellStart[c] = cellStart[c - 1];
+	cellStart[0] = 0;
+}
+
+int TargetGrid::query(Vector3 from, Vector3 to, float radius, float depth, std::vector<int>& candidates) const
+{
+	// bounding box of the segment grown by the hit volume
+	float minX = (from.x < to.x ? from.x : to.x) - radius;
+	float maxX = (from.x > to.x ? from.x : to.x) + radius;
+	float minZ = (from.z < to.z ? from.z : to.z) - depth;
+	float maxZ = (from.z > to.z ? from.z : to.z) + depth;
+
+	// nothing can be hit outside the grid (cellX/cellZ clamp)
+	if (cellStart.empty() || maxX < originX || maxZ < originZ
+		|| minX > originX + cellsX * gridCellSize || minZ > originZ + cellsZ * gridCellSize)
+		return 0;
+
+	int found = 0;
+	int x0 = cellX(minX), x1 = cellX(maxX);
+	int z0 = cellZ(minZ), z1 = cellZ(maxZ);
+	for (int cz = z0; cz <= z1; cz++)
+	{
+		for (int cx = x0; cx <= x1; cx++)
+		{
+			int c = cz * cellsX + cx;
+			for (int k = cellStart[c]; k < cellStart[c + 1]; k++)
+			{
+				candidates.push_back(cellDucks[k]);
+				found++;
+			}
+		}
+	}
+	return found;
+}
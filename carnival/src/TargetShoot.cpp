@@ -1,4 +1,4 @@
-///////////////////////////////////////////////////////////////////////////////
+﻿///////////////////////////////////////////////////////////////////////////////
 // main.cpp
 // ========
 // Based on Song Ho Cylinder Example
@@ -15,6 +15,7 @@
 #include <ctime>
 #include <sstream>
 #include <iomanip>
+#include <cmath>
 
 #define GLEW_STATIC
 #include <GL/glew.h>
@@ -32,12 +33,20 @@
 #include <glm/gtx/quaternion.hpp>
 
 #include "Matrices.h"
+#include "MatrixStack.h"
+#include "Renderer.h"
 
 #include "CubeMesh.h"
-#include "QuadMesh.h"
-#include "SineWaveStrip.h"
-#include "DuckTarget.h"
+#include "DuckSystem.h"
 #include "Gun.h"
+#include "Simulation.h"
+#include "SimClock.h"
+#include "FrameScheduler.h"
+#include "FrameProfiler.h"
+#include "TraceRecorder.h"
+#include "InputLog.h"
+#include "PerfHud.h"
+#include "Scene.h"
 
 #include "SOIL.h"
 
@@ -53,138 +62,38 @@ void mouseCB(int button, int stat, int x, int y);
 void moveGun(int x, int y);
 void initGL();
 void InitGLEW();
-bool initGLSL();
-int  initGLUT(int argc, char** argv);
+int  initGLUT(int& argc, char** argv);
+bool parseArguments(int argc, char** argv);
 bool initGlobalVariables();
 void clearSharedMem();
 void initLights();
 void setCamera(float posX, float posY, float posZ, float targetX, float targetY, float targetZ);
-void animationHandler(int param);
 // function for initializing sounds for when duck is shot 
 void initSounds();
 void toPerspective();
 // function for loading textures for booth and mesh (ground)
 void loadTextures();
-// function for shooting gun which flattens duck on hit and plays audio sound 
-void shootGun(int value);
+GLuint loadTexture(const char* fileName);
+// plays audio sound when a duck was hit
+void playHitSound();
+// saves the trace ring to TRACE_FILE
+void writeTrace();
+// saves the recorded input to inputLogFile
+void saveInputLog();
+// gun input from the mouse, recorded (--record) or ignored (--replay)
+void applyInput(InputLog::Type type, float x, float y);
+void inputLogTick();
 
 // constants
 const int   SCREEN_WIDTH = 900;
 const int   SCREEN_HEIGHT = 600;
 const float CAMERA_DISTANCE = 24.0f;
-const int   TEXT_WIDTH = 8;
-const int   TEXT_HEIGHT = 13;
-
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
-
-
-// Vertex Shaders source for bullseye target 
-const char* vsBullseyeSource = R"(
-// GLSL version
-#version 110
-
-varying vec3 normal;
-varying vec3 position;
-varying vec3 bullsEyeCenter;
-
-uniform vec3 targetCenter;
-
-void main(void) {
-    gl_Position = gl_ModelViewProjectionMatrix * gl_Vertex;
-    
-    // all passed in eye coords 
-    position = vec3(gl_ModelViewMatrix * gl_Vertex);
-    normal = normalize(gl_NormalMatrix * gl_Normal);
-    bullsEyeCenter = vec3(gl_ModelViewMatrix * vec4(targetCenter, 1.0));
-}
-)";
-
-// Fragment Shaders source for bullseye target
-const char* fsBullseyeSource = R"(
-// GLSL version
-#version 110
-
-varying vec3 normal;
-varying vec3 position;
-varying vec3 bullsEyeCenter;
-
-// uniforms
-uniform vec4 lightPosition;             // should be in the eye space
-uniform vec4 lightAmbient;              // light ambient color
-uniform vec4 lightDiffuse;              // light diffuse color
-uniform vec4 lightSpecular;             // light specular color
-uniform vec4 materialAmbient;           // material ambient color
-uniform vec4 materialDiffuse;           // material diffuse color
-uniform vec4 materialSpecular;          // material specular color
-uniform float materialShininess;        // material specular shininess
-
-void main()
-{
-    // get color of duck in lighting 
-    vec3 norm = normalize(normal);
-    vec3 light;
-    if(lightPosition.w == 0.0)
-    {
-        light = normalize(lightPosition.xyz);
-    }
-    else
-    {
-        light = normalize(lightPosition.xyz - position);
-    }
-    vec3 view = normalize(-position);
-    vec3 halfv = normalize(light + view);
-
-    vec3 color = lightAmbient.rgb * materialAmbient.rgb;        // begin with ambient
-    float dotNL = max(dot(norm, light), 0.0);
-    color += lightDiffuse.rgb * materialDiffuse.rgb * dotNL;    // add diffuse
-                  // modulate texture map
-    float dotNH = max(dot(norm, halfv), 0.0);
-    color += pow(dotNH, materialShininess) * lightSpecular.rgb * materialSpecular.rgb; // add specular
-
-
-    // code to determine how bullseye pixels are colored
-    float ringRadius = length(position - bullsEyeCenter);
-
-    // inner should be red 
-    if (ringRadius < 0.4) {
-        gl_FragColor = vec4(1.0, 0.0, 0.0, 1.0);
-    // should be same color as duck 
-    } else if (ringRadius < 0.7) {
-        gl_FragColor = vec4(color, materialDiffuse.a);
-    // else, outer ring should be red       
-    } else {
-        gl_FragColor = vec4(1.0, 0.0, 0.0, 1.0);
-    }
-}
-)";
-
-// Laser point vertex shader and fragment shader 
-// Vertex Shaders source for bullseye target 
-const char* vsLaserSource = R"(
-// GLSL version
-#version 110
-
-varying vec2 uv;
-
-void main(void) {
-    gl_Position = gl_ModelViewProjectionMatrix * gl_Vertex;
-    gl_PointSize = 12.0;
-}
-)";
-
-// Fragment Shaders source for bullseye target
-const char* fsLaserSource = R"(
-// GLSL version
-#version 110
-void main(void) {
-    gl_FragColor = vec4(0.0, 1.0, 0.0, 1.0);
-}
-)";
+const double SIM_TICK_SECONDS = 0.01;   // fixed simulation step, independent of the frame rate
+const int   FRAME_MILLISEC = 10;        // how often the clock runs and a pending frame is checked
+const double TARGET_FPS = 60.0;         // frames drawn at most this often (the fps argument overrides)
+const char* TRACE_FILE = "carnival_trace.json"; // written by 'd' and at exit
 
 // Global variables
-void* font = GLUT_BITMAP_8_BY_13;
 int screenWidth;
 int screenHeight;
 bool mouseLeftDown;
@@ -205,51 +114,45 @@ int imageHeight;
 Matrix4 matrixModelView;
 Matrix4 matrixProjection;
 // GLSL
-GLuint progId = 0;                  // ID of GLSL program (bullseye)
-GLuint progId2 = 1;                 // ID of GLSL program (laser)
 GLuint skyboxTexID;                 // skybox
 bool glslSupported;
 
-// Variables
-GLint uniformBullsEyeCenter;
-GLint uniformLightPosition;
-GLint uniformLightAmbient;
-GLint uniformLightDiffuse;
-GLint uniformLightSpecular;
-GLint uniformMaterialAmbient;
-GLint uniformMaterialDiffuse;
-GLint uniformMaterialSpecular;
-GLint uniformMaterialShininess;
-GLint attribVertexPosition;
-GLint attribVertexNormal;
-GLint attribVertexTexCoord;
+// Core profile renderer: lit program, light 0 and the solids the gun is made of
+Renderer* renderer = NULL;
 
 // Duck Targets
-DuckTarget* duckTarget;
-DuckTarget* duckTarget2;
-DuckTarget* duckTarget3;
-DuckTarget* duckTarget4;
-DuckTarget* duckTarget5;
-DuckTarget* duckTarget6;
-
-// Gun
-Gun* gun;
-
-// Booth consists of top, sides and bottom
-CubeMesh* boothTop = NULL;
-CubeMesh* boothLeftSide = NULL;
-CubeMesh* boothRightSide = NULL;
-CubeMesh* boothFront = NULL;
-bool drawBoothFront = true;
-bool moving = false;
+// gallery is made of lanes, each lane is one loop of six ducks (three on top, three flipped below)
+int galleryLanes = 1;
+const float LANE_SPACING = 4.0f;    // distance between lanes (negative z)
+
+// performance overlay, 'h' shows/hides it
+PerfHud* perfHud = NULL;
+
+// Ducks, gun, bullets and hit detection (no GL in there)
+Simulation* simulation = NULL;
+
+// Ground, ducks, booth, water, sky and laser, drawn by displayCB
+Scene* scene = NULL;
+
+// fixed timestep clock driving Simulation::tick()
+SimClock simClock(SIM_TICK_SECONDS);
+// redraw requests folded into one frame per interval, none while nothing changes
+FrameScheduler frameScheduler(TARGET_FPS);
+// 'p' stops the simulation (and so the redraws it asks for)
+bool paused = false;
+// CPU and GPU time of each pass of displayCB, 't' prints it
+FrameProfiler profiler;
+// timeline of callbacks, passes, ticks and loading for the Chrome trace viewer
+TraceRecorder trace;
+// --record saves the gun input of the session, --replay plays one back instead of the mouse
+InputLog inputLog;
+const char* inputLogFile = NULL;
+bool recordingInput = false;
+bool replayingInput = false;
 
 // A flat open mesh
-// Default Mesh Size
+// Default Mesh Size (quads per side, the texture still repeats 16 times)
 int meshSize = 16;
-QuadMesh* groundMesh = NULL;
-
-// Water waves
-static SineWaveMesh sineWaveMesh;
 
 
 // Arcade Booth 
@@ -270,11 +173,9 @@ Uint8* soundBuffer = NULL;
 Uint32 soundLength = 0;
 SDL_AudioStream* stream;
 
-#include <direct.h>
-
-
 // skybox
 GLuint loadCubemap(std::vector<std::string> faces) {
+    TraceScope scope(trace, "loadCubemap", "load");
     GLuint textureID;
     glGenTextures(1, &textureID);
     glBindTexture(GL_TEXTURE_CUBE_MAP, textureID);
@@ -307,18 +208,46 @@ GLuint loadCubemap(std::vector<std::string> faces) {
 ///////////////////////////////////////////////////////////////////////////////
 int main(int argc, char** argv)
 {
+    profiler.setTrace(&trace);
 
     // init global vars
     initGlobalVariables();
 
-    // init GLUT and GL
+    // init GLUT and GL, GLUT takes its own arguments out of argv
     initGLUT(argc, argv);
+
+    if (!parseArguments(argc, argv))
+        return 1;
+
+    // the trace is saved however the program ends (escape, window closed), not for a bad command line
+    atexit(writeTrace);
+    if (recordingInput)
+    {
+        inputLog.start(SIM_TICK_SECONDS, galleryLanes);
+        atexit(saveInputLog);
+    }
+    else if (replayingInput)
+    {
+        if (inputLog.load(inputLogFile))
+        {
+            // same gallery the session was recorded with
+            galleryLanes = inputLog.getLanes();
+            simulation->setupGallery(galleryLanes, LANE_SPACING);
+            if (inputLog.getTickSeconds() != SIM_TICK_SECONDS)
+                std::cerr << "input log was recorded with " << inputLog.getTickSeconds() << " s ticks, its hits will not match" << std::endl;
+            std::cout << "replaying " << inputLog.getTicks() << " ticks from " << inputLogFile << std::endl;
+        }
+        else
+        {
+            std::cerr << "cannot read input log " << inputLogFile << std::endl;
+            replayingInput = false;
+        }
+    }
     initGL();
     InitGLEW();
 
     // ducks immediately start moving as soon as program starts running
-    moving = true;
-    glutTimerFunc(10, animationHandler, 0);
+    simulation->setMoving(true);
 
     // load textures
     loadTextures();
@@ -330,17 +259,21 @@ int main(int argc, char** argv)
     std::cout << "Video card supports GLSL." << std::endl;
     // compile shaders and create GLSL program
     // If failed to create GLSL, reset flag to false
-    glslSupported = initGLSL();
+    // laser and skybox programs, ground, water and ducks go to the GPU once
+    glslSupported = renderer->initGLSL() && scene->initGLSL(*renderer);
+
+    // one cube buffer for every booth piece
+    CubeMesh::CreateMeshVBO();
 
-    // pass shaders to duck targets
-    duckTarget->getShaders(progId);
-    duckTarget2->getShaders(progId);
-    duckTarget3->getShaders(progId);
-    duckTarget4->getShaders(progId);
-    duckTarget5->getShaders(progId);
-    duckTarget6->getShaders(progId);
+    // timer queries for the per pass GPU times
+    profiler.init();
 
-    groundMesh->CreateMeshVBO(meshSize, attribVertexPosition, attribVertexNormal);
+    perfHud = new PerfHud();
+    if (!perfHud->initGLSL())
+    {
+        delete perfHud;
+        perfHud = NULL;
+    }
 
     glutMainLoop(); /* Start GLUT event-processing loop */
 
@@ -348,10 +281,52 @@ int main(int argc, char** argv)
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+// program arguments left after GLUT's, prints the usage on anything else
+///////////////////////////////////////////////////////////////////////////////
+bool parseArguments(int argc, char** argv)
+{
+    // [fps] [--record file | --replay file], fps 0 draws whenever something changed
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        std::string error;
+        char* end;
+        double fps = strtod(argv[i], &end);
+        if (arg == "--record" || arg == "--replay")
+        {
+            // one log per session, and its file is not another option
+            if (inputLogFile)
+                error = "only one of --record and --replay can be given";
+            else if (i + 1 >= argc || argv[i + 1][0] == '-')
+                error = arg + " needs a file";
+            else
+            {
+                inputLogFile = argv[++i];
+                recordingInput = arg == "--record";
+                replayingInput = !recordingInput;
+            }
+        }
+        else if (end != argv[i] && *end == '\0' && fps >= 0.0)
+            frameScheduler.setTargetFps(fps);
+        else
+            error = "unknown argument " + arg;
+
+        if (!error.empty())
+        {
+            std::cerr << error << std::endl;
+            std::cerr << "usage: carnival [fps] [--record file | --replay file]" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 // initialize GLUT for windowing
 ///////////////////////////////////////////////////////////////////////////////
-int initGLUT(int argc, char** argv)
+int initGLUT(int& argc, char** argv)
 {
     // GLUT stuff for windowing
     // initialization openGL window.
@@ -360,6 +335,11 @@ int initGLUT(int argc, char** argv)
 
     glutInitDisplayMode(GLUT_RGBA | GLUT_DOUBLE | GLUT_DEPTH | GLUT_STENCIL);   // display mode
 
+    // 3.3 core profile, nothing of the fixed-function pipeline is left to emulate
+    glutInitContextVersion(3, 3);
+    glutInitContextProfile(GLUT_CORE_PROFILE);
+    glutInitContextFlags(GLUT_FORWARD_COMPATIBLE);
+
     glutInitWindowSize(screenWidth, screenHeight);  // window size
 
     glutInitWindowPosition(100, 100);               // window location
@@ -371,7 +351,7 @@ int initGLUT(int argc, char** argv)
 
     // register GLUT callback functions
     glutDisplayFunc(displayCB);
-    glutTimerFunc(10, timerCB, 0);             // redraw only every given millisec
+    glutTimerFunc(FRAME_MILLISEC, timerCB, FRAME_MILLISEC);   // run the simulation clock and post pending frames
     glutReshapeFunc(reshapeCB);
     glutKeyboardFunc(keyboardCB);
     glutMouseFunc(mouseCB);
@@ -415,16 +395,12 @@ void InitGLEW()
 ///////////////////////////////////////////////////////////////////////////////
 void initGL()
 {
-    glShadeModel(GL_SMOOTH);                    // shading mathod: GL_SMOOTH or GL_FLAT
     glPixelStorei(GL_UNPACK_ALIGNMENT, 4);      // 4-byte pixel alignment
 
     // enable /disable features
-    glHint(GL_PERSPECTIVE_CORRECTION_HINT, GL_NICEST);
-    glHint(GL_LINE_SMOOTH_HINT, GL_NICEST);
     glEnable(GL_DEPTH_TEST);
-    glEnable(GL_LIGHTING);
-    glEnable(GL_TEXTURE_2D);
     glEnable(GL_CULL_FACE);
+    glEnable(GL_PROGRAM_POINT_SIZE);            // laser point size comes from its shader
 
     glClearColor(0.02f, 0.02f, 0.1f, 1.0f);     // background color - changed so sky is dark blue 
     glClearStencil(0);                          // clear stencil buffer
@@ -433,142 +409,6 @@ void initGL()
 
     initSounds();
     initLights();
-
-    // Other OpenGL setup
-    glEnable(GL_DEPTH_TEST);   // Remove hidded surfaces
-    glShadeModel(GL_SMOOTH);   // Use smooth shading, makes boundaries between polygons harder to see 
-    glClearDepth(1.0f);
-    glEnable(GL_NORMALIZE);    // Renormalize normal vectors 
-    glHint(GL_PERSPECTIVE_CORRECTION_HINT, GL_NICEST);   // Nicer perspective
-
-    glMatrixMode(GL_MODELVIEW);
-    glLoadIdentity();
-}
-
-
-///////////////////////////////////////////////////////////////////////////////
-// create glsl programs
-///////////////////////////////////////////////////////////////////////////////
-bool initGLSL()
-{
-
-    const int MAX_LENGTH = 2048;
-    char log[MAX_LENGTH];
-    int logLength = 0;
-
-    // create shader and program for bullseye
-    GLuint vsId = glCreateShader(GL_VERTEX_SHADER);
-    GLuint fsId = glCreateShader(GL_FRAGMENT_SHADER);
-    progId = glCreateProgram();
-
-    // create shader and program for laser 
-    GLuint vsId2 = glCreateShader(GL_VERTEX_SHADER);
-    GLuint fsId2 = glCreateShader(GL_FRAGMENT_SHADER);
-    progId2 = glCreateProgram();
-
-    // load shader sources
-    glShaderSource(vsId, 1, &vsBullseyeSource, NULL);
-    glShaderSource(fsId, 1, &fsBullseyeSource, NULL);
-    glShaderSource(vsId2, 1, &vsLaserSource, NULL);
-    glShaderSource(fsId2, 1, &fsLaserSource, NULL);
-
-    // compile shader sources
-    glCompileShader(vsId);
-    glCompileShader(fsId);
-    glCompileShader(vsId2);
-    glCompileShader(fsId2);
-
-    //@@ debug - only for bullseye
-    int vsStatus, fsStatus;
-    glGetShaderiv(vsId, GL_COMPILE_STATUS, &vsStatus);
-    if (vsStatus == GL_FALSE)
-    {
-        glGetShaderiv(vsId, GL_INFO_LOG_LENGTH, &logLength);
-        glGetShaderInfoLog(vsId, MAX_LENGTH, &logLength, log);
-        std::cout << "===== Vertex Shader Log =====\n" << log << std::endl;
-        return false;
-    }
-    glGetShaderiv(fsId, GL_COMPILE_STATUS, &fsStatus);
-    if (fsStatus == GL_FALSE)
-    {
-        glGetShaderiv(fsId, GL_INFO_LOG_LENGTH, &logLength);
-        glGetShaderInfoLog(fsId, MAX_LENGTH, &logLength, log);
-        std::cout << "===== Fragment Shader Log =====\n" << log << std::endl;
-        return false;
-    }
-
-    // attach shaders to the program
-    glAttachShader(progId, vsId);
-    glAttachShader(progId, fsId);
-    glAttachShader(progId2, vsId2);
-    glAttachShader(progId2, fsId2);
-
-    // link program for bullseye
-    glLinkProgram(progId);
-
-    // get uniform/attrib locations
-    glUseProgram(progId);
-    uniformBullsEyeCenter = glGetUniformLocation(progId, "targetCenter");
-    uniformLightPosition = glGetUniformLocation(progId, "lightPosition");
-    uniformLightAmbient = glGetUniformLocation(progId, "lightAmbient");
-    uniformLightDiffuse = glGetUniformLocation(progId, "lightDiffuse");
-    uniformLightSpecular = glGetUniformLocation(progId, "lightSpecular");
-    uniformMaterialAmbient = glGetUniformLocation(progId, "materialAmbient");
-    uniformMaterialDiffuse = glGetUniformLocation(progId, "materialDiffuse");
-    uniformMaterialSpecular = glGetUniformLocation(progId, "materialSpecular");
-    uniformMaterialShininess = glGetUniformLocation(progId, "materialShininess");
-
-    // Set uniform values
-    float centerObjectCoords[] = { 0.0f, 0.0f, 0.0f, 1.0f };
-    float lightPosition[] = { -4.0f, 8.0f, 8.0f, 1.0f };
-    float lightAmbient[] = { 0.3f, 0.3f, 0.3f, 1 };
-    float lightDiffuse[] = { 1.0f, 1.0f, 1.0f, 1 };
-    float lightSpecular[] = { 1.0f, 1.0f, 1.0f, 1 };
-    float materialAmbient[] = { 0.957f, 0.74f, 0.047f, 1.0f };
-    float materialDiffuse[] = { 0.957f, 0.74f, 0.047f, 1.0f };
-    float materialSpecular[] = { 0.5f, 0.5f, 0.5f, 1.0f };
-    float materialShininess = 100.0F;
-
-    glUniform3f(uniformBullsEyeCenter, 0, 0, 0);
-    glUniform4fv(uniformLightPosition, 1, lightPosition);
-    glUniform4fv(uniformLightAmbient, 1, lightAmbient);
-    glUniform4fv(uniformLightDiffuse, 1, lightDiffuse);
-    glUniform4fv(uniformLightSpecular, 1, lightSpecular);
-    glUniform4fv(uniformMaterialAmbient, 1, materialAmbient);
-    glUniform4fv(uniformMaterialDiffuse, 1, materialDiffuse);
-    glUniform4fv(uniformMaterialSpecular, 1, materialSpecular);
-    glUniform1f(uniformMaterialShininess, materialShininess);
-
-    // unbind GLSL
-    glUseProgram(0);
-
-    // link program for laser
-    glLinkProgram(progId2);
-
-
-    // check GLSL status
-    int linkStatus;
-    int linkStatus2;
-    glGetProgramiv(progId, GL_LINK_STATUS, &linkStatus);
-    glGetProgramiv(progId2, GL_LINK_STATUS, &linkStatus2);
-    if (linkStatus == GL_FALSE)
-    {
-        glGetProgramiv(progId, GL_INFO_LOG_LENGTH, &logLength);
-        glGetProgramInfoLog(progId, MAX_LENGTH, &logLength, log);
-        std::cout << "===== GLSL Program Log =====\n" << log << std::endl;
-        return false;
-    }
-    else if (linkStatus2 == GL_FALSE) {
-        glGetProgramiv(progId2, GL_INFO_LOG_LENGTH, &logLength);
-        glGetProgramInfoLog(progId2, MAX_LENGTH, &logLength, log);
-        std::cout << "===== Pointer Laser Log =====\n" << log << std::endl;
-        return false;
-    }
-    else
-    {
-        return true;
-    }
-    return true;
 }
 
 
@@ -589,56 +429,15 @@ bool initGlobalVariables()
 
     drawMode = 0; // 0:fill, 1: wireframe, 2:points
 
-    // Create Targets
-    // on wave, x coordinate initially at -8.0f
-    duckTarget = new DuckTarget();
-    // on wave, x coordinate is -8.0f + 8.0f = 0.0f
-    duckTarget2 = new DuckTarget(0.f);
-    // on wave, x coordinate is -8.0f + 16.0f = 8.0f
-    duckTarget3 = new DuckTarget(8.0f);
-
-    // below wave, x coordinate is same as ducks above but flipped 
-    duckTarget4 = new DuckTarget(8.0f, true);
-    duckTarget5 = new DuckTarget(0.f, true);
-    duckTarget6 = new DuckTarget(-8.0f, true);
-
-    // add gun 
-    gun = new Gun();
-
-    // Set up ground quad mesh
-    Vector3 origin = Vector3(-32.0f, -9.0f, 48.0f);
-    Vector3 dir1v = Vector3(1.0f, 0.0f, 0.0f);
-    Vector3 dir2v = Vector3(0.0f, 0.0f, -1.0f);
-    groundMesh = new QuadMesh(meshSize, 64.0);
-    groundMesh->InitMesh(meshSize, origin, 64.0, 64.0, dir1v, dir2v);
-
-
-    Vector3 ambient = Vector3(0.0f, 1.0f, 0.0f);
-    Vector3 diffuse = Vector3(0.0f, 0.8f, 0.0f);
-    Vector3 specular = Vector3(0.04f, 0.04f, 0.04f);
-    float shininess = 0.2;
-    groundMesh->SetMaterial(ambient, diffuse, specular, shininess);
-
-    boothTop = new CubeMesh();
-    ambient = Vector3(0.2f, 0.00f, 0.0f);
-    diffuse = Vector3(0.9f, 0.9f, 0.9f);
-    specular = Vector3(0.5f, 0.5f, 0.5f);
-    shininess = 4.0;
-    boothTop->setMaterial(ambient, diffuse, specular, shininess);
-
-    boothFront = new CubeMesh();
-    boothFront->setMaterial(ambient, diffuse, specular, shininess);
-
-    boothLeftSide = new CubeMesh();
-    ambient = Vector3(0.2f, 0.2f, 0.2f);
-    diffuse = Vector3(0.7f, 0.7f, 0.7f);
-    specular = Vector3(1.0f, 1.0f, 1.0f);
-    shininess = 4.0;
-    boothLeftSide->setMaterial(ambient, diffuse, specular, shininess);
-
-    boothRightSide = new CubeMesh();
-
-    boothRightSide->setMaterial(ambient, diffuse, specular, shininess);
+    // GL objects of the renderer are made later by initGLSL(), light and camera are plain values
+    renderer = new Renderer();
+
+    // Create Targets (one loop of six ducks per lane) and the gun
+    simulation = new Simulation(SIM_TICK_SECONDS);
+    simulation->setupGallery(galleryLanes, LANE_SPACING);
+
+    // ground grid and booth pieces, their GL objects are made by Scene::initGLSL()
+    scene = new Scene(meshSize);
 
     return true;
 }
@@ -687,6 +486,15 @@ void clearSharedMem()
         vboId1 = iboId1 = 0;
         vboId2 = iboId2 = 0;
     }
+
+    delete scene;
+    scene = NULL;
+    CubeMesh::DeleteMeshVBO();
+    profiler.release();
+    delete perfHud;
+    perfHud = NULL;
+    delete renderer;
+    renderer = NULL;
 }
 
 
@@ -700,21 +508,10 @@ void initLights()
     GLfloat lightKa[] = { .05f, .05f, .05f, 1.0f };  // ambient light
     GLfloat lightKd[] = { 0.7f, 0.8f, 1.0f, 1.0f };  // diffuse light
     GLfloat lightKs[] = { 1, 1, 1, 1 };           // specular light
-    glLightfv(GL_LIGHT0, GL_AMBIENT, lightKa);
-    glLightfv(GL_LIGHT0, GL_DIFFUSE, lightKd);
-    glLightfv(GL_LIGHT0, GL_SPECULAR, lightKs);
-
-    // position the light
-    float lightPos[4] = { -4.0, 8.0f, 8.0f, 1.0f }; // directional light
-    glLightfv(GL_LIGHT0, GL_POSITION, lightPos);
-    glEnable(GL_LIGHTING);
-    glEnable(GL_LIGHT0);
-
-    glEnable(GL_DEPTH_TEST);   // Remove hidded surfaces
-    glShadeModel(GL_SMOOTH);   // Use smooth shading, makes boundaries between polygons harder to see 
-    glClearDepth(1.0f);
-    glEnable(GL_NORMALIZE);    // Renormalize normal vectors 
 
+    // position the light, in eye space so it moves with the camera
+    float lightPos[4] = { -4.0, 8.0f, 8.0f, 1.0f }; // point light
+    renderer->setLight(lightPos, lightKa, lightKd, lightKs);
 }
 
 
@@ -724,65 +521,64 @@ void initLights()
 ///////////////////////////////////////////////////////////////////////////////
 void setCamera(float posX, float posY, float posZ, float targetX, float targetY, float targetZ)
 {
-    glMatrixMode(GL_MODELVIEW);
-    glLoadIdentity();
-    gluLookAt(posX, posY, posZ, targetX, targetY, targetZ, 0, 1, 0); // eye(x,y,z), focal(x,y,z), up(x,y,z)
+    MatrixStack view;
+    view.lookAt(Vector3(posX, posY, posZ), Vector3(targetX, targetY, targetZ), Vector3(0, 1, 0)); // eye(x,y,z), focal(x,y,z), up(x,y,z)
+    matrixModelView = view.top();
 }
 
 
 
-void loadTextures()
+///////////////////////////////////////////////////////////////////////////////
+// load an image into a mipmapped, repeating 2D texture (0 on failure)
+// SOIL_load_OGL_texture looks up extensions with glGetString(GL_EXTENSIONS), which a
+// core profile does not answer, so only the image loading is left to SOIL
+///////////////////////////////////////////////////////////////////////////////
+GLuint loadTexture(const char* fileName)
 {
-    // load side of the booths (left and right)
-    boothSideTexture = SOIL_load_OGL_texture(
-        "./src/boothSides.bmp",
-        SOIL_LOAD_AUTO,
-        SOIL_CREATE_NEW_ID,
-        SOIL_FLAG_MIPMAPS | SOIL_FLAG_INVERT_Y | SOIL_FLAG_NTSC_SAFE_RGB | SOIL_FLAG_COMPRESS_TO_DXT
-    );
-
-    if (boothSideTexture == 0) {
-        printf("SOIL loading error: %s for booth sides\n", SOIL_last_result());
+    // callers pass literals, so the name can stay in the trace
+    TraceScope scope(trace, "loadTexture", "load", fileName);
+    int width, height, channels;
+    unsigned char* image = SOIL_load_image(fileName, &width, &height, &channels, SOIL_LOAD_RGB);
+    if (!image) {
+        printf("SOIL loading error: '%s' for %s\n", SOIL_last_result(), fileName);
+        return 0;
     }
 
+    // bottom row first, same as SOIL_FLAG_INVERT_Y
+    std::vector<unsigned char> flipped(width * height * 3);
+    for (int row = 0; row < height; row++)
+        std::copy(image + row * width * 3, image + (row + 1) * width * 3, flipped.begin() + (height - 1 - row) * width * 3);
+    SOIL_free_image_data(image);
 
-    // load top of the booth
-    boothTopTexture = SOIL_load_OGL_texture(
-        "./src/boothTop.bmp",
-        SOIL_LOAD_AUTO,
-        SOIL_CREATE_NEW_ID,
-        SOIL_FLAG_MIPMAPS | SOIL_FLAG_INVERT_Y | SOIL_FLAG_NTSC_SAFE_RGB | SOIL_FLAG_COMPRESS_TO_DXT
-    );
-
-    if (boothTop == 0) {
-        printf("SOIL loading error: '%s for booth top\n", SOIL_last_result());
-    }
+    GLuint textureID;
+    glGenTextures(1, &textureID);
+    glBindTexture(GL_TEXTURE_2D, textureID);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, flipped.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return textureID;
+}
 
+void loadTextures()
+{
+    TraceScope scope(trace, "loadTextures", "load");
+    // load side of the booths (left and right)
+    boothSideTexture = loadTexture("./src/boothSides.bmp");
 
     // load top of the booth
-    boothFrontTexture = SOIL_load_OGL_texture(
-        "./src/boothFront.bmp",
-        SOIL_LOAD_AUTO,
-        SOIL_CREATE_NEW_ID,
-        SOIL_FLAG_MIPMAPS | SOIL_FLAG_INVERT_Y | SOIL_FLAG_NTSC_SAFE_RGB | SOIL_FLAG_COMPRESS_TO_DXT
-    );
-
-    if (boothFrontTexture == 0) {
-        printf("SOIL loading error: '%s' for booth front\n", SOIL_last_result());
-    }
+    boothTopTexture = loadTexture("./src/boothTop.bmp");
 
+    // load front of the booth
+    boothFrontTexture = loadTexture("./src/boothFront.bmp");
 
     // for ground texture 
-    groundMeshTexture = SOIL_load_OGL_texture(
-        "./src/groundMesh.bmp",
-        SOIL_LOAD_AUTO,
-        SOIL_CREATE_NEW_ID,
-        SOIL_FLAG_MIPMAPS | SOIL_FLAG_INVERT_Y | SOIL_FLAG_NTSC_SAFE_RGB | SOIL_FLAG_COMPRESS_TO_DXT
-    );
-
-    if (groundMeshTexture == 0) {
-        printf("SOIL loading error: '%s' for ground mesh\n", SOIL_last_result());
-    }
+    groundMeshTexture = loadTexture("./src/groundMesh.bmp");
 
     // for skybox
     std::vector<std::string> skyBoxFaces = {
@@ -795,57 +591,9 @@ void loadTextures()
     };
 
     skyboxTexID = loadCubemap(skyBoxFaces);
-}
-
-// function to draw skybox
-void drawSkybox(float size) {
-    glDepthMask(GL_FALSE);
-    glDisable(GL_LIGHTING);
-    glDisable(GL_CULL_FACE);
-
-    glBindTexture(GL_TEXTURE_CUBE_MAP, skyboxTexID);
-    glEnable(GL_TEXTURE_CUBE_MAP);
-
-    glBegin(GL_QUADS);
-
-
-    glTexCoord3f(1, -1, -1); glVertex3f(size, -size, -size);
-    glTexCoord3f(1, -1, 1); glVertex3f(size, -size, size);
-    glTexCoord3f(1, 1, 1); glVertex3f(size, size, size);
-    glTexCoord3f(1, 1, -1); glVertex3f(size, size, -size);
 
-    glTexCoord3f(-1, -1, 1); glVertex3f(-size, -size, size);
-    glTexCoord3f(-1, -1, -1); glVertex3f(-size, -size, -size);
-    glTexCoord3f(-1, 1, -1); glVertex3f(-size, size, -size);
-    glTexCoord3f(-1, 1, 1); glVertex3f(-size, size, size);
-
-    glTexCoord3f(-1, 1, -1); glVertex3f(-size, size, -size);
-    glTexCoord3f(1, 1, -1); glVertex3f(size, size, -size);
-    glTexCoord3f(1, 1, 1); glVertex3f(size, size, size);
-    glTexCoord3f(-1, 1, 1); glVertex3f(-size, size, size);
-
-    glTexCoord3f(-1, -1, 1); glVertex3f(-size, -size, size);
-    glTexCoord3f(1, -1, 1); glVertex3f(size, -size, size);
-    glTexCoord3f(1, -1, -1); glVertex3f(size, -size, -size);
-    glTexCoord3f(-1, -1, -1); glVertex3f(-size, -size, -size);
-
-    glTexCoord3f(-1, -1, 1); glVertex3f(-size, -size, size);
-    glTexCoord3f(-1, 1, 1); glVertex3f(-size, size, size);
-    glTexCoord3f(1, 1, 1); glVertex3f(size, size, size);
-    glTexCoord3f(1, -1, 1); glVertex3f(size, -size, size);
-
-    glTexCoord3f(1, -1, -1); glVertex3f(size, -size, -size);
-    glTexCoord3f(1, 1, -1); glVertex3f(size, size, -size);
-    glTexCoord3f(-1, 1, -1); glVertex3f(-size, size, -size);
-    glTexCoord3f(-1, -1, -1); glVertex3f(-size, -size, -size);
-
-    glEnd();
-
-    glEnable(GL_LIGHTING);
-    glEnable(GL_CULL_FACE);
-    glDisable(GL_TEXTURE_CUBE_MAP);
-    glDepthMask(GL_TRUE);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+    Scene::Textures textures = { groundMeshTexture, boothTopTexture, boothSideTexture, boothFrontTexture, skyboxTexID };
+    scene->setTextures(textures);
 }
 
 
@@ -861,6 +609,8 @@ void toPerspective()
 
     // set viewport to be the entire window
     glViewport(0, 0, (GLsizei)screenWidth, (GLsizei)screenHeight);
+    if (renderer)
+        renderer->setViewport(screenWidth, screenHeight);
 
     // construct perspective projection matrix
     float aspectRatio = (float)(screenWidth) / screenHeight;
@@ -874,82 +624,73 @@ void toPerspective()
     matrixProjection[11] = -1;
     matrixProjection[14] = -(2 * F * N) / (F - N);
     matrixProjection[15] = 0;
-
-    // set perspective viewing frustum
-    glMatrixMode(GL_PROJECTION);
-    glLoadMatrixf(matrixProjection.get());
     //@@ equivalent fixed pipeline
-    //glLoadIdentity();
     //gluPerspective(60.0f, (float)(screenWidth)/screenHeight, 0.2f, 40.0f); // FOV, AspectRatio, NearClip, FarClip
-
-    // switch to modelview matrix in order to set scene
-    glMatrixMode(GL_MODELVIEW);
-    glLoadIdentity();
 }
 
 //=============================================================================
-// Shooting gun (bullet) animation
+// Trace
 //=============================================================================
-// check if gun is in motion
-
-void shootGun(int value) {
-    // get boolean to check if bullet is in motion (ex. bullet has been shot)
-    bool inMotion = gun->isInMotion();
-    if (inMotion) {
-        // get current bullet position
-        Vector3 bulletCoords = gun->getBulletWorldCoords();
-
-        // check if bullet hits any of the ducks and flip them if they do 
-        if (duckTarget->hit(bulletCoords)) {
-            duckTarget->flip();
-            // play sound 
-            SDL_ClearAudioStream(stream);
-            SDL_PutAudioStreamData(stream, soundBuffer, soundLength);
-        }
-
-        // check if bullet hits any of the ducks and flip them if they do 
-        if (duckTarget2->hit(bulletCoords)) {
-            duckTarget2->flip();
-            SDL_ClearAudioStream(stream);
-            SDL_PutAudioStreamData(stream, soundBuffer, soundLength);
-        }
-
-        // check if bullet hits any of the ducks and flip them if they do 
-        if (duckTarget3->hit(bulletCoords)) {
-            duckTarget3->flip();
-            SDL_ClearAudioStream(stream);
-            SDL_PutAudioStreamData(stream, soundBuffer, soundLength);
-        }
-
-        // check if bullet hits any of the ducks and flip them if they do 
-        if (duckTarget4->hit(bulletCoords)) {
-            duckTarget4->flip();
-            SDL_ClearAudioStream(stream);
-            SDL_PutAudioStreamData(stream, soundBuffer, soundLength);
-        }
-
-        // check if bullet hits any of the ducks and flip them if they do 
-        if (duckTarget5->hit(bulletCoords)) {
-            duckTarget5->flip();
-            SDL_ClearAudioStream(stream);
-            SDL_PutAudioStreamData(stream, soundBuffer, soundLength);
+void writeTrace()
+{
+    if (trace.write(TRACE_FILE))
+        std::cout << "trace written to " << TRACE_FILE << " (" << trace.getRecorded() << " events recorded)" << std::endl;
+    else
+        std::cerr << "could not write " << TRACE_FILE << std::endl;
+}
 
-        }
+//=============================================================================
+// Input log
+//=============================================================================
+void saveInputLog()
+{
+    if (inputLog.save(inputLogFile))
+        std::cout << "input log written to " << inputLogFile << " (" << inputLog.getInputCount() << " inputs, "
+                  << inputLog.getTicks() << " ticks)" << std::endl;
+    else
+        std::cerr << "could not write " << inputLogFile << std::endl;
+}
 
-        // check if bullet hits any of the ducks and flip them if they do 
-        if (duckTarget6->hit(bulletCoords)) {
-            duckTarget6->flip();
-            SDL_ClearAudioStream(stream);
-            SDL_PutAudioStreamData(stream, soundBuffer, soundLength);
+// live gun input goes through here, stamped with the tick it goes into
+void applyInput(InputLog::Type type, float x, float y)
+{
+    // the replay owns the gun until it ends
+    if (replayingInput)
+        return;
+    InputLog::Input input = { simulation->getTicks(), type, x, y };
+    if (recordingInput)
+        inputLog.record(input);
+    InputLog::apply(*simulation, input);
+}
 
+// after each tick, the replay ends once the recorded session has been played
+void inputLogTick()
+{
+    if (recordingInput)
+        inputLog.recordTick(*simulation);
+    else if (replayingInput)
+    {
+        inputLog.checkHits(*simulation);
+        if (simulation->getTicks() >= inputLog.getTicks())
+        {
+            if (inputLog.hitsMatch())
+                std::cout << "replay done, " << inputLog.getHitCount() << " hits match the recording" << std::endl;
+            else if (inputLog.getMismatchTick() >= 0)
+                std::cout << "replay done, hits differ from the recording from tick " << inputLog.getMismatchTick() << std::endl;
+            else
+                std::cout << "replay done, recorded hits were not hit" << std::endl;
+            replayingInput = false;
         }
-
-        // move the bullet (animate)
-        gun->moveBullet();
-        glutPostRedisplay();
-        glutTimerFunc(10, shootGun, 0);
     }
+}
 
+//=============================================================================
+// Hit sound
+//=============================================================================
+void playHitSound() {
+    TraceScope scope(trace, "hit sound", "audio");
+    SDL_ClearAudioStream(stream);
+    SDL_PutAudioStreamData(stream, soundBuffer, soundLength);
 }
 
 
@@ -959,96 +700,65 @@ void shootGun(int value) {
 
 void displayCB()
 {
-    // Clear buffer
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
-    glMatrixMode(GL_MODELVIEW);
-    glLoadIdentity();
-
-    gluLookAt(0, 0, 0, cameraX, 2.0, cameraZ, 0, 1, 0);
-    drawSkybox(50.0f);
+    TraceScope scope(trace, "display", "frame");
 
+    // requested or not (expose, resize), this frame covers every pending request
+    double frameStart = SimClock::now();
+    frameScheduler.frameDrawn(frameStart);
+    if (perfHud)
+        perfHud->frame(frameStart);
 
+    // Clear buffer
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
     if (!vboSupported || !glslSupported)
+    {
+        glutSwapBuffers();
         return;
+    }
 
-
-    glBindTexture(GL_TEXTURE_2D, groundMeshTexture); // texture for ground mesh (repeat it)
-    groundMesh->DrawMesh(meshSize);
-    glBindTexture(GL_TEXTURE_2D, 0); // reset textures
-
-    // Draw everything else using fixed pipeline and immediate mode rendering
-    glLoadIdentity();
+    // sky is seen from the origin so it never gets closer
+    MatrixStack skyView;
+    skyView.lookAt(Vector3(0, 0, 0), Vector3(cameraX, 2.0f, cameraZ), Vector3(0, 1, 0));
 
     // Create Viewing Matrix V
-    gluLookAt(cameraX, 2.0, cameraZ, 0.0, 2.0, 0.0, 0.0, 1.0, 0.0);
-
-    // Draw duck target in five different positions
-    // use fragment shader to determine which target pixels to replace with bullseye ring pixels
-
-    // glUseProgram(progId);
-    duckTarget->draw();
-    duckTarget2->draw();
-    duckTarget3->draw();
-    duckTarget4->draw();
-    duckTarget5->draw();
-    duckTarget6->draw();
-    // glUseProgram(0);        // turn off shaders
-
-    // draw gun
-    gun->draw();
-
-    // draw/render laser
-    gun->drawLaser(progId2);
-
-    // Draw Booth 
-    glBindTexture(GL_TEXTURE_2D, boothTopTexture); // texture for booth top
-    glPushMatrix();
-    glTranslatef(0, 12.0f, -8.0);
-    glScalef(16.0f, 2.0f, 2.0f);
-    boothTop->drawCubeMesh();
-    glPopMatrix();
-
-    glBindTexture(GL_TEXTURE_2D, boothSideTexture); // texture for booth sides
-
-    glPushMatrix();
-    glTranslatef(-14.0, 0.0f, -8.0);
-    glScalef(1.0f, 10.0f, 2.0f);
-    boothLeftSide->drawCubeMesh();
-    glPopMatrix();
-
-    glPushMatrix();
-    glTranslatef(14.0, 0.0f, -8.0);
-    glScalef(1.0f, 10.0f, 2.0f);
-    boothRightSide->drawCubeMesh();
-    glPopMatrix();
+    setCamera(cameraX, 2.0f, cameraZ, 0.0f, 2.0f, 0.0f);
 
+    // ducks and bullets are drawn between the last two simulation ticks
+    float alpha = simClock.getAlpha();
+    profiler.beginFrame();
+    scene->draw(*renderer, *simulation, matrixModelView, skyView.top(), matrixProjection, alpha, &profiler);
 
-
-    if (drawBoothFront)
+    // overlay on top of everything
+    profiler.begin(FrameProfiler::HUD);
+    if (perfHud && perfHud->isVisible())
     {
-        glBindTexture(GL_TEXTURE_2D, boothFrontTexture); // texture for booth front
-        glPushMatrix();
-        glTranslatef(0, -6.0, -6.0);
-        glScalef(12.0f, 4.0f, 0.5f);
-        boothFront->drawCubeMesh();
-        glPopMatrix();
+        PerfHud::Stats stats;
+        DuckSystem& ducks = simulation->getDucks();
+        // every pass so far, the duck batch, water and skybox included
+        stats.drawCalls = renderer->getDrawCalls();
+        stats.triangles = renderer->getTriangles();
+        stats.stateChanges = renderer->getStateChanges();
+        stats.stateChangesAvoided = renderer->getStateChangesAvoided();
+        stats.culled = renderer->getCulled() + scene->getDucksCulled();
+        stats.ticks = simulation->getTicks();
+        stats.ducks = ducks.size();
+        stats.ducksStanding = 0;
+        for (int i = 0; i < stats.ducks; i++)
+            stats.ducksStanding += ducks.isFlipped(i) ? 0 : 1;
+        stats.bullets = simulation->getGun().getBulletCount();
+        perfHud->draw(stats, screenWidth, screenHeight);
     }
+    profiler.end();
 
-    glBindTexture(GL_TEXTURE_2D, 0); // reset textures
-
-    // Draw water waves with sine wave function
-    glPushMatrix();
-    glTranslatef(0.0, -6.0, -14.0);
-    glRotatef(-180, 0, 1, 0);
-    drawSineWaveMesh();
-    glPopMatrix();
-
+    profiler.begin(FrameProfiler::SWAP);
     glutSwapBuffers();
+    profiler.end();
 }
 
 
 void reshapeCB(int w, int h)
 {
+    TraceScope scope(trace, "reshape", "input");
     screenWidth = w;
     screenHeight = h;
     toPerspective();
@@ -1058,42 +768,83 @@ void reshapeCB(int w, int h)
 void timerCB(int millisec)
 {
     glutTimerFunc(millisec, timerCB, millisec);
-    glutPostRedisplay();
+    TraceScope scope(trace, "timer", "sim");
+
+    // run as many fixed ticks as real time has passed, the rest carries over to the next frame
+    int ticks = paused ? 0 : simClock.advance();
+    for (int i = 0; i < ticks; i++) {
+        double tickStart = SimClock::now();
+        if (replayingInput)
+            inputLog.replay(*simulation);
+        simulation->tick();
+        simClock.tickDone();
+        inputLogTick();
+        trace.complete("tick", "sim", tickStart, SimClock::now());
+
+        // bullet flipped a duck this tick
+        if (simulation->getTickHits() > 0)
+        {
+            trace.instant("duck hit", "sim");
+            playHitSound();
+        }
+    }
+
+    // ducks, bullets and water all move with the ticks, the HUD shows live numbers
+    if (ticks > 0 || (perfHud && perfHud->isVisible()))
+        frameScheduler.requestRedraw();
+    if (frameScheduler.frameDue(SimClock::now()))
+        glutPostRedisplay();
 }
 
 bool stop = false;
 
 void keyboardCB(unsigned char key, int x, int y)
 {
+    TraceScope scope(trace, "keyboard", "input");
     switch (key)
     {
     case 27: // ESCAPE
         clearSharedMem();
         exit(0);
         break;
+    case 'r': // render stats of the last frame
+        std::cout << "draw calls " << renderer->getDrawCalls()
+                  << ", state changes " << renderer->getStateChanges()
+                  << ", avoided " << renderer->getStateChangesAvoided()
+                  << ", culled " << renderer->getCulled() + scene->getDucksCulled() << std::endl;
+        std::cout << "frames " << frameScheduler.getFrames()
+                  << ", redraw requests " << frameScheduler.getRequests()
+                  << ", coalesced " << frameScheduler.getCoalesced()
+                  << ", idle slots " << frameScheduler.getIdleSlots() << std::endl;
+        frameScheduler.resetStats();
+        break;
+    case 'h': // performance overlay
+        if (perfHud)
+        {
+            perfHud->setVisible(!perfHud->isVisible());
+            frameScheduler.requestRedraw();
+        }
+        break;
+    case 'd': // save the trace so far
+        writeTrace();
+        break;
+    case 't': // frame time per pass over the last frames
+        profiler.print();
+        profiler.reset();
+        break;
+    case 'p': // pause/resume the gallery
+        paused = !paused;
+        // time spent paused is not simulated
+        if (!paused)
+            simClock.resync();
+        break;
     default:
         ;
     }
 }
 
-void animationHandler(int param)
-{
-    if (moving) {
-        // animate ducks around track
-        duckTarget->animate(true);
-        duckTarget2->animate(true);
-        duckTarget3->animate(true);
-        duckTarget4->animate(true);
-        duckTarget5->animate(true);
-        duckTarget6->animate(true);
-        glutPostRedisplay();
-        glutTimerFunc(12, animationHandler, 0);
-    }
-
-}
-
-
 void mouseCB(int button, int state, int x, int y) {
+    TraceScope scope(trace, "mouse", "input");
     mouseX = x;
     mouseY = y;
 
@@ -1101,10 +852,9 @@ void mouseCB(int button, int state, int x, int y) {
     {
         if (state == GLUT_DOWN)
         {
-            // if the mouse was left clicked, shoot a bullet (animate it)
+            // if the mouse was left clicked, shoot a bullet, the simulation ticks move it
             mouseLeftDown = true;
-            gun->shoot();
-            glutTimerFunc(10, shootGun, 0);
+            applyInput(InputLog::SHOOT, 0.0f, 0.0f);
         }
         else if (state == GLUT_UP)
             mouseLeftDown = false;
@@ -1133,9 +883,11 @@ void mouseCB(int button, int state, int x, int y) {
 
 void moveGun(int x, int y)
 {
+    TraceScope scope(trace, "motion", "input");
     // move the gun around the screen, 0.01 works well so the sensitivity isn't too high
-    gun->moveGun(-0.01 * (mouseX - x), 0.01 * (mouseY - y));
+    applyInput(InputLog::MOVE, (float)(-0.01 * (mouseX - x)), (float)(0.01 * (mouseY - y)));
     mouseX = x;
     mouseY = y;
-    glutPostRedisplay();
+    // drawn with the next frame, however many motion events come before it
+    frameScheduler.requestRedraw();
 }
\ No newline at end of file
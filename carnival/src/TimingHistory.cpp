@@ -0,0 +1,43 @@
+#include <algorithm>
+
+#include "TimingHistory.h"
+
+TimingHistory::TimingHistory()
+{
+	clear();
+}
+
+void TimingHistory::add(float milliseconds)
+{
+	samples[next] = milliseconds;
+	next = (next + 1) % CAPACITY;
+	if (count < CAPACITY)
+		count++;
+}
+
+void TimingHistory::clear()
+{
+	next = 0;
+	count = 0;
+}
+
+TimingHistory::Summary TimingHistory::summarize() const
+{
+	Summary summary = { 0.0f, 0.0f, 0.0f, count };
+	if (count == 0)
+		return summary;
+
+	// the ring is only full or filled from slot 0, so the first count slots are the samples
+	std::vector<float> sorted(samples, samples + count);
+	std::sort(sorted.begin(), sorted.end());
+
+	float sum = 0.0f;
+	for (int i = 0; i < count; i++)
+		sum += sorted[i];
+	summary.min = sorted[0];
+	summary.avg = sum / count;
+	// nearest rank
+	int rank = (int)(0.99f * count + 0.5f);
+	summary.p99 = sorted[std::min(std::max(rank, 1), count) - 1];
+	return summary;
+}
@@ -0,0 +1,124 @@
+#include <cstdio>
+
+#include "SimClock.h"
+#include "TraceRecorder.h"
+
+TraceRecorder::TraceRecorder(int capacity)
+{
+	unsigned long long size = 1;
+	while (size < (unsigned long long)capacity)
+		size <<= 1;
+	slots = new Slot[size];
+	for (unsigned long long i = 0; i < size; i++)
+		slots[i].sequence.store(0, std::memory_order_relaxed);
+	mask = size - 1;
+	next.store(0, std::memory_order_relaxed);
+	origin = SimClock::now();
+}
+
+TraceRecorder::~TraceRecorder()
+{
+	delete[] slots;
+}
+
+int TraceRecorder::threadIndex()
+{
+	// small numbers in the order threads first record, the viewer shows one row per thread
+	static std::atomic<int> threads(0);
+	static thread_local int index = ++threads;
+	return index;
+}
+
+void TraceRecorder::record(const Event& event)
+{
+	unsigned long long index = next.fetch_add(1, std::memory_order_relaxed);
+	Slot& slot = slots[index & mask];
+	slot.sequence.store(0, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	slot.event = event;
+	slot.sequence.store(index + 1, std::memory_order_release);
+}
+
+void TraceRecorder::complete(const char* name, const char* category, double start, double end, const char* detail)
+{
+	Event event = { name, category, detail, start, end - start, threadIndex(), 'X' };
+	record(event);
+}
+
+void TraceRecorder::instant(const char* name, const char* category, const char* detail)
+{
+	Event event = { name, category, detail, SimClock::now(), 0.0, threadIndex(), 'i' };
+	record(event);
+}
+
+// names are literals from our own code, only quotes and backslashes need escaping
+static void writeString(FILE* file, const char* text)
+{
+	fputc('"', file);
+	for (const char* c = text; *c; c++)
+	{
+		if (*c == '"' || *c == '\\')
+			fputc('\\', file);
+		fputc(*c, file);
+	}
+	fputc('"', file);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Chrome trace event format: times in microseconds from the recorder's creation.
+// A slot rewritten while it is read is skipped (its sequence changes).
+///////////////////////////////////////////////////////////////////////////////
+bool TraceRecorder::write(const char* fileName) const
+{
+	FILE* file = fopen(fileName, "w");
+	if (!file)
+		return false;
+
+	unsigned long long end = next.load(std::memory_order_acquire);
+	unsigned long long capacity = mask + 1;
+	unsigned long long first = end > capacity ? end - capacity : 0;
+
+	fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	bool comma = false;
+	for (unsigned long long i = first; i < end; i++)
+	{
+		const Slot& slot = slots[i & mask];
+		if (slot.sequence.load(std::memory_order_acquire) != i + 1)
+			continue;
+		Event event = slot.event;
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (slot.sequence.load(std::memory_order_relaxed) != i + 1)
+			continue;
+
+		fprintf(file, "%s{\"name\":", comma ? ",\n" : "");
+		writeString(file, event.name);
+		fprintf(file, ",\"cat\":");
+		writeString(file, event.category);
+		fprintf(file, ",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%d", event.phase, (event.start - origin) * 1.0e6, event.thread);
+		if (event.phase == 'X')
+			fprintf(file, ",\"dur\":%.3f", event.duration * 1.0e6);
+		else
+			fprintf(file, ",\"s\":\"t\"");
+		if (event.detail)
+		{
+			fprintf(file, ",\"args\":{\"detail\":");
+			writeString(file, event.detail);
+			fprintf(file, "}");
+		}
+		fprintf(file, "}");
+		comma = true;
+	}
+	fprintf(file, "\n]}\n");
+	return fclose(file) == 0;
+}
+
+TraceScope::TraceScope(TraceRecorder& recorder, const char* name, const char* category, const char* detail)
+	: recorder(recorder), name(name), category(category), detail(detail)
+{
+	start = SimClock::now();
+}
+
+TraceScope::~TraceScope()
+{
+	recorder.complete(name, category, start, SimClock::now(), detail);
+}